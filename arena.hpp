@@ -0,0 +1,165 @@
+#ifndef arena_hpp
+#define arena_hpp
+
+/*
+ A region (arena) allocator for graph adjacency storage.  Memory is
+ carved sequentially out of large chunks, so building a graph is a
+ stream of pointer bumps instead of millions of small mallocs, and the
+ edge storage of a graph ends up packed together in a few big blocks.
+
+ Freed blocks of the small sizes edge storage uses (hash nodes, bucket
+ arrays of small maps, ...) go onto per size free lists and are handed
+ out again, so insert/erase churn reuses memory.  Everything else is
+ only given back all at once:  by release() or when the arena itself
+ is destroyed.  So a graph using an arena can be torn down wholesale;
+ the arena must outlive every container that allocates from it.
+
+ arenaAllocator<T> is the (stateful) standard allocator that hands out
+ memory from an arena.  Use it as the A parameter of digraph/ungraph:
+
+   arena a;
+   typedef arenaAllocator<char> alloc_t;
+   digraph<int, hashEdges, alloc_t> g(n, alloc_t(&a));
+
+ NOTE: an arena is NOT thread safe.
+*/
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class arena {
+public:
+  explicit arena(size_t chunk_size = 1 << 20);
+  ~arena();
+
+  void* allocate(size_t nbytes);
+  void  deallocate(void* p, size_t nbytes);
+
+  void   release();    // free every chunk (everything ever allocated)
+  size_t bytesReserved() const { return m_reserved; }  // total chunk bytes
+  size_t bytesInUse() const { return m_inuse; }        // handed out, live
+private:
+  arena(arena const&);             // not copyable
+  arena& operator=(arena const&);
+
+  enum { ALIGN = 16,               // alignment of every block
+	 NCLASSES = 16 };          // free lists for sizes up to 16*ALIGN
+
+  static size_t roundup(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+
+  struct freeBlock {
+    freeBlock* next;
+  };
+
+  std::vector<char*> m_chunks;     // every chunk (for release())
+  size_t     m_chunk_size;
+  char*      m_cur;                // bump pointer into the newest chunk
+  char*      m_end;
+  freeBlock* m_free[NCLASSES];     // free list per size class
+  size_t     m_reserved;
+  size_t     m_inuse;
+};
+
+inline arena::arena(size_t chunk_size)
+  : m_chunk_size(chunk_size), m_cur(0), m_end(0),
+    m_reserved(0), m_inuse(0)
+{
+  for (int i = 0; i < NCLASSES; i++) {
+    m_free[i] = 0;
+  }
+}
+
+inline arena::~arena()
+{
+  release();
+}
+
+inline void* arena::allocate(size_t nbytes)
+{
+  nbytes = roundup(nbytes ? nbytes : 1);
+  m_inuse += nbytes;
+
+  size_t c = nbytes / ALIGN - 1;   // size class
+  if (c < NCLASSES && m_free[c]) {
+    freeBlock* b = m_free[c];
+    m_free[c] = b->next;
+    return b;
+  }
+
+  if (nbytes > (size_t) (m_end - m_cur)) {
+    // big requests get a chunk of their own (the current one is kept)
+    size_t sz = (nbytes > m_chunk_size / 4) ? nbytes : m_chunk_size;
+    char* p = static_cast<char*>(::operator new(sz));
+    m_chunks.push_back(p);
+    m_reserved += sz;
+    if (sz == nbytes)
+      return p;
+    m_cur = p;
+    m_end = p + sz;
+  }
+
+  void* p = m_cur;
+  m_cur += nbytes;
+  return p;
+}
+
+inline void arena::deallocate(void* p, size_t nbytes)
+{
+  nbytes = roundup(nbytes ? nbytes : 1);
+  m_inuse -= nbytes;
+
+  size_t c = nbytes / ALIGN - 1;
+  if (c < NCLASSES) {
+    freeBlock* b = static_cast<freeBlock*>(p);
+    b->next = m_free[c];
+    m_free[c] = b;
+  }
+  // larger blocks are only reclaimed by release()
+}
+
+inline void arena::release()
+{
+  for (size_t i = 0; i < m_chunks.size(); i++) {
+    ::operator delete(m_chunks[i]);
+  }
+  m_chunks.clear();
+  m_cur = m_end = 0;
+  for (int i = 0; i < NCLASSES; i++) {
+    m_free[i] = 0;
+  }
+  m_reserved = m_inuse = 0;
+}
+
+template <class T>
+class arenaAllocator {
+public:
+  typedef T value_type;
+
+  explicit arenaAllocator(arena* a) : m_arena(a) {}
+  template <class U>
+  arenaAllocator(arenaAllocator<U> const& o) : m_arena(o.m_arena) {}
+
+  T* allocate(size_t n)
+    { return static_cast<T*>(m_arena->allocate(n * sizeof(T))); }
+  void deallocate(T* p, size_t n) { m_arena->deallocate(p, n * sizeof(T)); }
+
+  arena* getArena() const { return m_arena; }
+private:
+  template <class U> friend class arenaAllocator;
+  arena* m_arena;
+};
+
+template <class T, class U>
+inline bool operator==(arenaAllocator<T> const& a, arenaAllocator<U> const& b)
+{
+  return a.getArena() == b.getArena();
+}
+
+template <class T, class U>
+inline bool operator!=(arenaAllocator<T> const& a, arenaAllocator<U> const& b)
+{
+  return a.getArena() != b.getArena();
+}
+
+#endif // arena_hpp
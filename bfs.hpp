@@ -0,0 +1,280 @@
+#ifndef bfs_hpp
+#define bfs_hpp
+
+/*
+ Direction optimizing breadth-first search (Beamer, Asanovic and
+ Patterson).  Each level is expanded either
+
+   top-down  - every frontier vertex claims its unvisited neighbors
+               (the frontier is a queue), or
+   bottom-up - every unvisited vertex looks for a parent among its
+               in-neighbors in the frontier (the frontier is a bitmap)
+               and stops at the first one it finds.
+
+ Top-down is cheap while the frontier is small;  once the edges out of
+ the frontier outnumber the edges still to explore by ALPHA, bottom-up
+ is cheaper (most checks succeed early), until the frontier shrinks
+ below n/BETA again.  On low diameter graphs this skips most edges.
+
+ Works over any graph with numVerts(), numEdges() and adj(v) (a range
+ of (neighbor, edge information) pairs):  digraph/ungraph, cowgraph,
+ csrgraph (whose neighbor arrays are read directly).  Bottom-up steps
+ need the in-neighbors of each vertex, from gin:  an undirected graph
+ is its own gin, a digraph tracking its in-edges can use an
+ inEdgeView of itself, or gin may be null (every level is top-down).
+
+ parent[v] is v's parent in the BFS tree (-1 for src and unreached
+ vertices), dist[v] its distance from src (-1 if unreached);  returns
+ the number of vertices reached.
+
+ parallelBfs() is a multithreaded level synchronous (top-down) BFS:
+ the threads claim chunks of the frontier, claim unvisited vertices
+ with an atomic compare and swap on their level and gather the next
+ frontier in per thread buffers.  Which frontier vertex becomes the
+ parent of a vertex then depends on timing;  with deterministic set
+ it is always the smallest id among its candidates instead (every one
+ of them gets a say via an atomic min), so the tree is the same for
+ any number of threads.
+*/
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include "digraph.hpp"
+#include "graphscan.hpp"
+#include "parallel.hpp"
+
+// a fixed size set of vertex ids, 64 per word
+class bitmap {
+public:
+  typedef unsigned long long word_t;
+
+  explicit bitmap(int n = 0) : m_bits((n + 63) / 64, 0) {}
+
+  bool test(int i) const { return (m_bits[i >> 6] >> (i & 63)) & 1; }
+  void set(int i)   { m_bits[i >> 6] |= (word_t) 1 << (i & 63); }
+  void reset(int i) { m_bits[i >> 6] &= ~((word_t) 1 << (i & 63)); }
+  void clear() { std::fill(m_bits.begin(), m_bits.end(), 0); }
+  void swap(bitmap& b) { m_bits.swap(b.m_bits); }
+
+  int words() const { return m_bits.size(); }
+  word_t  word(int w) const { return m_bits[w]; }
+  word_t* data() { return m_bits.data(); }
+private:
+  std::vector<word_t> m_bits;
+};
+
+// the in-edges of a digraph (which must track them) seen as a graph
+template <class G>
+class inEdgeView {
+public:
+  typedef typename G::inEdges_t::const_iterator const_iterator;
+
+  explicit inEdgeView(G const& g) : m_g(g) {}
+  int numVerts() const { return m_g.numVerts(); }
+  typename G::inEdges_t const& adj(int v) const { return m_g.inAdj(v); }
+private:
+  G const& m_g;
+};
+
+template <class G, class H>
+int hybridBfs(G const& g, H const* gin, int src,
+	      std::vector<int>& parent, std::vector<int>& dist)
+{
+  const int ALPHA = 14;
+  const int BETA = 24;
+  const int n = g.numVerts();
+
+  parent.assign(n, -1);
+  dist.assign(n, -1);
+  bitmap visited(n);
+  bitmap front(n), next(n);       // bottom-up frontiers
+  std::vector<int> queue, nextq;  // top-down frontiers
+  queue.reserve(n);
+  nextq.reserve(n);
+
+  visited.set(src);
+  dist[src] = 0;
+  queue.push_back(src);
+  int reached = 1;
+  int nf = 1;                              // vertices in frontier
+  long long mf = g.adj(src).size();        // edges out of frontier
+  long long mu = (long long) g.numEdges() - mf;   // edges unexplored
+  bool bottomUp = false;
+
+  for (int level = 1; nf > 0; level++) {
+    if (!bottomUp && gin && mf > mu / ALPHA) {
+      front.clear();
+      for (size_t i = 0; i < queue.size(); i++) {
+	front.set(queue[i]);
+      }
+      bottomUp = true;
+    }
+    else if (bottomUp && nf < n / BETA) {
+      queue.clear();
+      for (int v = 0; v < n; v++) {
+	if (front.test(v))
+	  queue.push_back(v);
+      }
+      bottomUp = false;
+    }
+
+    const int prev = reached;
+    mf = 0;
+    if (!bottomUp) {
+      nextq.clear();
+      for (size_t i = 0; i < queue.size(); i++) {
+	const int v = queue[i];
+	scanNbrs(g, v, [&](int w) {
+	  if (!visited.test(w)) {
+	    visited.set(w);
+	    parent[w] = v;
+	    dist[w] = level;
+	    nextq.push_back(w);
+	    mf += g.adj(w).size();
+	  }
+	  return false;
+	});
+      }
+      queue.swap(nextq);
+      reached += queue.size();
+    }
+    else {
+      next.clear();
+      // unvisited vertices a word at a time
+      for (int wd = 0; wd < visited.words(); wd++) {
+	for (bitmap::word_t todo = ~visited.word(wd); todo; todo &= todo - 1) {
+	  const int v = wd * 64 + __builtin_ctzll(todo);
+	  if (v >= n)
+	    break;
+	  scanNbrs(*gin, v, [&](int u) {
+	    if (!front.test(u))
+	      return false;
+	    parent[v] = u;
+	    dist[v] = level;
+	    next.set(v);
+	    reached++;
+	    mf += g.adj(v).size();
+	    return true;
+	  });
+	}
+      }
+      // the new frontier is visited too (only after the sweep, so it
+      // doesn't skip vertices)
+      for (int wd = 0; wd < visited.words(); wd++) {
+	visited.data()[wd] |= next.word(wd);
+      }
+      front.swap(next);
+    }
+    nf = reached - prev;
+    mu -= mf;
+  }
+  return reached;
+}
+
+// for undirected graphs, which are their own in-edge graph
+template <class G>
+inline int hybridBfs(G const& g, int src, std::vector<int>& parent,
+		     std::vector<int>& dist)
+{
+  return hybridBfs(g, &g, src, parent, dist);
+}
+
+template <class G>
+int parallelBfs(G const& g, int src, std::vector<int>& parent,
+		std::vector<int>& dist, int nthreads = defaultThreads(),
+		bool deterministic = false)
+{
+  nthreads = threadCount(nthreads);
+  const int n = g.numVerts();
+  const size_t CHUNK = 64;        // frontier vertices claimed at a time
+
+  std::vector<std::atomic<int> > level(n), par(n);
+  for (int v = 0; v < n; v++) {
+    level[v].store(-1, std::memory_order_relaxed);
+    par[v].store(-1, std::memory_order_relaxed);
+  }
+  level[src].store(0);
+
+  std::vector<int> front[2];      // this level's and the next frontier
+  front[0].push_back(src);
+  std::vector<std::vector<int> > bufs(nthreads);
+  std::vector<size_t> offset(nthreads + 1);
+  std::atomic<size_t> pos(0);
+  spinBarrier barrier(nthreads);
+  int reached = 1;
+
+  parallelRun(nthreads, [&](int tid) {
+    for (int lvl = 1; ; lvl++) {
+      std::vector<int> const& cur = front[(lvl - 1) & 1];
+      std::vector<int>& out = bufs[tid];
+      out.clear();
+
+      // expand claimed chunks of the frontier
+      for (;;) {
+	const size_t b = pos.fetch_add(CHUNK);
+	if (b >= cur.size())
+	  break;
+	const size_t e = std::min(b + CHUNK, cur.size());
+	for (size_t i = b; i < e; i++) {
+	  const int v = cur[i];
+	  scanNbrs(g, v, [&](int w) {
+	    int l = level[w].load(std::memory_order_relaxed);
+	    if (l < 0 && level[w].compare_exchange_strong(l, lvl)) {
+	      out.push_back(w);
+	      l = lvl;
+	      if (!deterministic) {
+		par[w].store(v, std::memory_order_relaxed);
+		return false;
+	      }
+	    }
+	    if (deterministic && l == lvl) {   // atomic min of the parents
+	      int p = par[w].load();
+	      while ((p < 0 || v < p) && !par[w].compare_exchange_weak(p, v))
+		;
+	    }
+	    return false;
+	  });
+	}
+      }
+      barrier.wait();
+
+      // lay the buffers out one after another in the next frontier
+      if (tid == 0) {
+	for (int t = 0; t < nthreads; t++) {
+	  offset[t+1] = offset[t] + bufs[t].size();
+	}
+	front[lvl & 1].resize(offset[nthreads]);
+	reached += offset[nthreads];
+	pos.store(0);
+      }
+      barrier.wait();
+
+      std::copy(out.begin(), out.end(), front[lvl & 1].begin() + offset[tid]);
+      barrier.wait();
+      if (offset[nthreads] == 0)
+	break;
+    }
+  });
+
+  parent.resize(n);
+  dist.resize(n);
+  for (int v = 0; v < n; v++) {
+    parent[v] = par[v].load(std::memory_order_relaxed);
+    dist[v] = level[v].load(std::memory_order_relaxed);
+  }
+  return reached;
+}
+
+// same, filling parent only (as digraph<T>::bfs() does)
+template <class G>
+inline int parallelBfs(G const& g, int src, std::vector<int>& parent,
+		       int nthreads = defaultThreads(),
+		       bool deterministic = false)
+{
+  std::vector<int> dist;
+  return parallelBfs(g, src, parent, dist, nthreads, deterministic);
+}
+
+#endif // bfs_hpp
@@ -0,0 +1,52 @@
+#include <vector>
+#include <string>
+
+#include "strfuncs.hpp"
+#include "bitgraph.hpp"
+
+using std::vector;
+using std::string;
+
+// level synchronous BFS on bit frontiers:  expanding vertex v ORs its
+// whole row (minus what is already visited) into the next frontier,
+// one word (64 vertices) at a time
+template <class T>
+void bitgraph<T>::bfs(int src, vector<int>& parent) const
+{
+  parent.clear();
+  parent.resize(numVerts(), -1);   // size = num verts and init to -1
+
+  vector<word_t> visited(m_words, 0);
+  vector<word_t> frontier(m_words, 0);
+  vector<word_t> next(m_words, 0);
+
+  visited[src / WORD_BITS] |= (word_t) 1 << (src % WORD_BITS);
+  frontier[src / WORD_BITS] |= (word_t) 1 << (src % WORD_BITS);
+
+  for (bool more = true; more; ) {
+    more = false;
+    for (int fi = 0; fi < m_words; fi++) {
+      for (word_t fw = frontier[fi]; fw; fw &= fw - 1) {
+	const int v = fi * WORD_BITS + __builtin_ctzll(fw);
+	word_t const* r = row(v);
+
+	for (int i = 0; i < m_words; i++) {
+	  word_t nw = r[i] & ~visited[i];   // newly reached through v
+	  if (!nw)
+	    continue;
+	  visited[i] |= nw;
+	  next[i] |= nw;
+	  more = true;
+	  for (; nw; nw &= nw - 1) {
+	    parent[i * WORD_BITS + __builtin_ctzll(nw)] = v;
+	  }
+	}
+      }
+    }
+    frontier.swap(next);
+    next.assign(m_words, 0);
+  }
+}
+
+// explicit member function template instantiation for ints
+template void bitgraph<int>::bfs(int src, vector<int>& parent) const;
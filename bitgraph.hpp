@@ -0,0 +1,280 @@
+#ifndef bitgraph_hpp
+#define bitgraph_hpp
+
+/*
+ A digraph stored as a packed bit adjacency matrix:  row v holds one
+ bit per vertex w, set when there is an edge v -> w.  Edge tests are a
+ single bit test (no hashing), and degrees, common neighbors and BFS
+ frontier expansion work on 64 vertices at a time with word wide
+ AND/OR/popcount loops.  Only the branch free popcount/AND kernels
+ (outDegree(), numEdges(), commonNeighbors()) are simple enough for
+ the compiler to vectorize, and only for a target with a vector
+ popcount (e.g. -mavx512vpopcntdq;  plain -mavx2 isn't enough);  the
+ BFS loop branches per word and stays scalar.  Edge information,
+ if wanted, lives in a parallel n x n matrix.
+
+ Meant for small, dense graphs (or dense subgraphs pulled out of a big
+ one):  storage is n*n bits (+ n*n T's when weighted) no matter how
+ many edges there are.
+
+ The read only interface mirrors digraph the way csrgraph's does
+ (numVerts(), adj(), findEdge(), it->first, it->second), and
+ scanNbrs()/scanEdges() below walk a row a word at a time, so the
+ shared code (graphout.hpp exporters, bfs.hpp, sssp.hpp, kcore.hpp,
+ ...) runs on it too.  Edges of an unweighted bitgraph read as T(1).
+*/
+
+#include <string>
+#include <vector>
+
+#include "graphout.hpp"
+
+template <class T>
+class bitgraph {
+public:
+  typedef unsigned long long word_t;
+  enum { WORD_BITS = 64 };
+
+  // (adjacent vertex, edge information) as seen through an iterator
+  struct edgeRef {
+    int first;
+    T   second;
+  };
+
+  // visits the set bits of a row in increasing order
+  class const_iterator {
+  public:
+    // operator-> must return something that itself has an operator->
+    struct arrow {
+      edgeRef r;
+      edgeRef const* operator->() const { return &r; }
+    };
+
+    const_iterator() : m_g(0), m_src(0), m_i(0), m_w(0) {}
+    // from word i on, leaving out the bits of word i not in mask
+    const_iterator(bitgraph const* g, int src, int i,
+		   word_t mask = ~(word_t) 0)
+      : m_g(g), m_src(src), m_i(i), m_w(0) { load(mask); }
+
+    edgeRef operator*() const
+      { edgeRef r = { dst(), m_g->edgeValue(m_src, dst()) }; return r; }
+    arrow operator->() const { arrow a = { **this }; return a; }
+
+    const_iterator& operator++() { m_w &= m_w - 1; skip(); return *this; }
+    const_iterator operator++(int)
+      { const_iterator t(*this); ++*this; return t; }
+
+    bool operator==(const_iterator const& o) const
+      { return m_i == o.m_i && m_w == o.m_w; }
+    bool operator!=(const_iterator const& o) const { return !(*this == o); }
+  private:
+    int  dst() const { return m_i * WORD_BITS + __builtin_ctzll(m_w); }
+    void load(word_t mask) {
+      if (m_i < m_g->wordsPerRow()) {
+	m_w = m_g->row(m_src)[m_i] & mask;
+	skip();
+      }
+    }
+    void skip() {
+      while (!m_w && ++m_i < m_g->wordsPerRow())
+	m_w = m_g->row(m_src)[m_i];
+    }
+
+    bitgraph const* m_g;
+    int    m_src;
+    int    m_i;          // word of the current bit (wordsPerRow() at end)
+    word_t m_w;          // bits of word m_i not visited yet
+  };
+  typedef const_iterator iterator;
+
+  // the edge list of one vertex (stands in for digraph<T>::umapEdge)
+  class edgeRange {
+  public:
+    edgeRange(bitgraph const* g, int src) : m_g(g), m_src(src) {}
+
+    const_iterator begin() const { return const_iterator(m_g, m_src, 0); }
+    const_iterator end() const
+      { return const_iterator(m_g, m_src, m_g->wordsPerRow()); }
+    size_t size() const { return m_g->outDegree(m_src); }
+    bool empty() const { return size() == 0; }
+
+    // iterator to edge or end()
+    const_iterator find(int key) const;
+  private:
+    bitgraph const* m_g;
+    int m_src;
+  };
+  typedef edgeRange umapEdge;
+
+  explicit bitgraph(int nverts, bool weighted = false);
+  template <class G>
+  explicit bitgraph(G const& g, bool weighted = true);  // from any digraph
+
+  int  numVerts() const { return m_n; }
+  int  numEdges() const;
+  bool weighted() const { return !m_wt.empty(); }
+
+  bool addEdge(int src, int dst, T const& e = T());  // false if present
+  bool delEdge(int src, int dst);                    // false if absent
+  bool hasEdge(int src, int dst) const
+    { return (row(src)[dst / WORD_BITS] >> (dst % WORD_BITS)) & 1; }
+  T const& weight(int src, int dst) const { return m_wt[src*m_n + dst]; }
+  // the edge's information, T(1) if unweighted (src -> dst must exist)
+  T edgeValue(int src, int dst) const
+    { return weighted() ? weight(src, dst) : T(1); }
+
+  edgeRange adj(int src) const { return edgeRange(this, src); }
+  edgeRange operator[] (int src) const { return adj(src); }
+  // returns iterator to edge or adj(src).end()
+  const_iterator findEdge(int src, int dst) const
+    { return adj(src).find(dst); }
+
+  int outDegree(int src) const { return popcount(row(src)); }
+  int commonNeighbors(int u, int v) const;   // |adj(u) & adj(v)|
+
+  // raw rows:  wordsPerRow() words, bit w of row v is edge v -> w
+  int wordsPerRow() const { return m_words; }
+  word_t const* row(int src) const { return &m_bits[src * m_words]; }
+
+  // simple graph algorithms
+  void bfs(int src, std::vector<int>& parent) const; // breadth-first search
+
+  // object-to-string conversion routines  (see graphout.hpp)
+  std::string toXML() const
+    { return graphToXML(*this); }
+  std::string toDIMACS(int src, int dst) const
+    { return graphToDIMACS<T>(*this, src, dst); }
+  std::string toAdjMat() const
+    { return graphToAdjMat<T>(*this); }
+private:
+  word_t* row(int src) { return &m_bits[src * m_words]; }
+  int popcount(word_t const* r) const;
+
+  int m_n;                      // number of vertices
+  int m_words;                  // words per row
+  std::vector<word_t> m_bits;   // n rows of m_words words
+  std::vector<T> m_wt;          // n x n edge information (if weighted)
+};
+
+template <class T>
+inline bitgraph<T>::bitgraph(int nverts, bool weighted)
+  : m_n(nverts), m_words((nverts + WORD_BITS - 1) / WORD_BITS),
+    m_bits(nverts * m_words, 0)
+{
+  if (weighted)
+    m_wt.resize(nverts * nverts);
+}
+
+template <class T>
+template <class G>
+bitgraph<T>::bitgraph(G const& g, bool weighted)
+  : m_n(g.numVerts()), m_words((g.numVerts() + WORD_BITS - 1) / WORD_BITS),
+    m_bits(g.numVerts() * m_words, 0)
+{
+  if (weighted)
+    m_wt.resize(m_n * m_n);
+
+  for (int v = 0; v < m_n; v++) {
+    for (typename G::const_iterator it = g.adj(v).begin();
+	 it != g.adj(v).end(); ++it) {
+      addEdge(v, it->first, it->second);
+    }
+  }
+}
+
+template <class T>
+inline int bitgraph<T>::popcount(word_t const* r) const
+{
+  int c = 0;
+  for (int i = 0; i < m_words; i++) {
+    c += __builtin_popcountll(r[i]);
+  }
+  return c;
+}
+
+template <class T>
+inline int bitgraph<T>::numEdges() const
+{
+  int m = 0;
+  for (size_t i = 0; i < m_bits.size(); i++) {
+    m += __builtin_popcountll(m_bits[i]);
+  }
+  return m;
+}
+
+template <class T>
+inline bool bitgraph<T>::addEdge(int src, int dst, T const& e)
+{
+  word_t& w = row(src)[dst / WORD_BITS];
+  const word_t bit = (word_t) 1 << (dst % WORD_BITS);
+  if (w & bit)
+    return false;
+  w |= bit;
+  if (weighted())
+    m_wt[src*m_n + dst] = e;
+  return true;
+}
+
+template <class T>
+inline bool bitgraph<T>::delEdge(int src, int dst)
+{
+  word_t& w = row(src)[dst / WORD_BITS];
+  const word_t bit = (word_t) 1 << (dst % WORD_BITS);
+  if (!(w & bit))
+    return false;
+  w &= ~bit;
+  return true;
+}
+
+template <class T>
+inline int bitgraph<T>::commonNeighbors(int u, int v) const
+{
+  word_t const* a = row(u);
+  word_t const* b = row(v);
+  int c = 0;
+  for (int i = 0; i < m_words; i++) {
+    c += __builtin_popcountll(a[i] & b[i]);
+  }
+  return c;
+}
+
+template <class T>
+inline typename bitgraph<T>::const_iterator
+bitgraph<T>::edgeRange::find(int key) const
+{
+  if (!m_g->hasEdge(m_src, key))
+    return end();
+  // (the bits before key's are left out)
+  return const_iterator(m_g, m_src, key / WORD_BITS,
+			~(word_t) 0 << (key % WORD_BITS));
+}
+
+// scanNbrs()/scanEdges() (see graphscan.hpp) straight off the bit rows
+template <class T, class F>
+inline bool scanNbrs(bitgraph<T> const& g, int v, F f)
+{
+  typedef typename bitgraph<T>::word_t word_t;
+  word_t const* r = g.row(v);
+  for (int i = 0; i < g.wordsPerRow(); i++) {
+    for (word_t w = r[i]; w; w &= w - 1) {
+      if (f(i * bitgraph<T>::WORD_BITS + __builtin_ctzll(w)))
+	return true;
+    }
+  }
+  return false;
+}
+
+template <class T, class F>
+inline void scanEdges(bitgraph<T> const& g, int v, F f)
+{
+  typedef typename bitgraph<T>::word_t word_t;
+  word_t const* r = g.row(v);
+  for (int i = 0; i < g.wordsPerRow(); i++) {
+    for (word_t w = r[i]; w; w &= w - 1) {
+      const int dst = i * bitgraph<T>::WORD_BITS + __builtin_ctzll(w);
+      f(dst, g.edgeValue(v, dst));
+    }
+  }
+}
+
+#endif // bitgraph_hpp
@@ -0,0 +1,166 @@
+#ifndef cbuilder_hpp
+#define cbuilder_hpp
+
+/*
+ Concurrent construction of a digraph/ungraph.  Each building thread
+ owns an append buffer and adds edges to it with no locking at all:
+
+   concurrentBuilder<iw_ungraph> b(nthreads, true);
+   parallelRun(nthreads, [&](int tid) { ... b.addEdge(tid, u, v, w); });
+   b.merge(g);
+
+ merge() then fills the graph in parallel:  every merge thread owns a
+ contiguous range of source vertices, collects the buffered edges of
+ its range from all the buffers and inserts them with addEdgesRange()
+ (counting sort, reserve, one pass per vertex), touching only the edge
+ lists of its own vertices.  Duplicate edges keep the first one added,
+ taking the buffers in thread order.
+
+ symmetric = true also buffers the reverse of every edge, which is what
+ an ungraph needs (ungraph::addEdge adds both directions).  merge()
+ rebuilds the in-edge index afterwards if the graph tracks one.
+ NOTE: an arena allocator is not thread safe, so graphs allocating
+ from one must be merged with a single thread.
+*/
+
+#include <vector>
+#include "parallel.hpp"
+
+template <class G>
+class concurrentBuilder {
+public:
+  typedef typename G::edge edge;
+
+  explicit concurrentBuilder(int nthreads = defaultThreads(),
+			     bool symmetric = false)
+    : m_bufs(threadCount(nthreads)), m_symmetric(symmetric) {}
+
+  int  numThreads() const { return m_bufs.size(); }
+  bool symmetric() const { return m_symmetric; }
+
+  // called by thread tid only (each thread has its own buffer)
+  template <class E>
+  void addEdge(int tid, int src, int dst, E const& e);
+  void reserve(int tid, size_t nedges) { m_bufs[tid].edges.reserve(nedges); }
+
+  size_t numBuffered() const;
+
+  // insert every buffered edge into g (which must already have all the
+  // vertices) and empty the buffers;  returns the number of edges added
+  // (counted once per undirected edge when symmetric)
+  int merge(G& g, bool compact = false, int nthreads = 0);
+private:
+  struct buffer {
+    std::vector<edge> edges;
+    char pad[64];               // keep neighboring buffers off one line
+  };
+
+  std::vector<buffer> m_bufs;
+  bool m_symmetric;
+};
+
+template <class G>
+template <class E>
+inline void concurrentBuilder<G>::addEdge(int tid, int src, int dst,
+					  E const& e)
+{
+  std::vector<edge>& b = m_bufs[tid].edges;
+  edge ed;
+  ed.src = src;
+  ed.dst = dst;
+  ed.e = e;
+  b.push_back(ed);
+  if (m_symmetric && src != dst) {
+    ed.src = dst;
+    ed.dst = src;
+    b.push_back(ed);
+  }
+}
+
+template <class G>
+inline size_t concurrentBuilder<G>::numBuffered() const
+{
+  size_t n = 0;
+  for (size_t i = 0; i < m_bufs.size(); i++) {
+    n += m_bufs[i].edges.size();
+  }
+  return n;
+}
+
+template <class G>
+int concurrentBuilder<G>::merge(G& g, bool compact, int nthreads)
+{
+  if (nthreads <= 0)
+    nthreads = numThreads();
+  const int nbufs = numThreads();
+  const int n = g.numVerts();
+
+  // the in-edge index is shared by all vertices:  rebuild it afterwards
+  const bool track = g.tracksInEdges();
+  g.trackInEdges(false);
+
+  // pass 1 (parallel over buffers):  split each buffer by merge range
+  // bins[b * nthreads + p] holds the edges of buffer b for range p
+  std::vector<std::vector<edge> > bins(nbufs * nthreads);
+  parallelRun(nthreads, [&](int tid) {
+    for (int b = tid; b < nbufs; b += nthreads) {
+      std::vector<edge>& src = m_bufs[b].edges;
+      std::vector<int> count(nthreads, 0);
+      for (size_t i = 0; i < src.size(); i++) {
+	count[rangeOwner(n, nthreads, src[i].src)]++;
+      }
+      for (int p = 0; p < nthreads; p++) {
+	bins[b * nthreads + p].reserve(count[p]);
+      }
+      for (size_t i = 0; i < src.size(); i++) {
+	bins[b * nthreads + rangeOwner(n, nthreads, src[i].src)]
+	  .push_back(src[i]);
+      }
+      std::vector<edge>().swap(src);
+    }
+  });
+
+  // pass 2 (parallel over vertex ranges):  insert.  symmetric mode
+  // buffers a self loop once, not twice, so the new ones are counted
+  // (before inserting) to turn the edges added into undirected edges
+  std::vector<int> added(nthreads, 0), loops(nthreads, 0);
+  parallelRun(nthreads, [&](int tid) {
+    int lo, hi;
+    splitRange(n, nthreads, tid, lo, hi);
+    size_t m = 0;
+    for (int b = 0; b < nbufs; b++) {
+      m += bins[b * nthreads + tid].size();
+    }
+    std::vector<edge> mine;
+    mine.reserve(m);
+    for (int b = 0; b < nbufs; b++) {
+      std::vector<edge>& bin = bins[b * nthreads + tid];
+      mine.insert(mine.end(), bin.begin(), bin.end());
+      std::vector<edge>().swap(bin);
+    }
+    if (m_symmetric) {
+      std::vector<bool> seen(hi - lo, false);
+      for (size_t i = 0; i < mine.size(); i++) {
+	const int v = mine[i].src;
+	if (v == mine[i].dst && !seen[v - lo]) {
+	  seen[v - lo] = true;
+	  if (g.findEdge(v, v) == g.adj(v).end())
+	    loops[tid]++;
+	}
+      }
+    }
+    added[tid] = g.addEdgesRange(mine.begin(), mine.end(), lo, hi, compact);
+  });
+
+  g.trackInEdges(track);
+
+  int total = 0, nloops = 0;
+  for (int p = 0; p < nthreads; p++) {
+    total += added[p];
+    nloops += loops[p];
+  }
+  // (each other new undirected edge was added in both directions)
+  return m_symmetric ? (total + nloops) / 2 : total;
+}
+
+#endif // cbuilder_hpp
@@ -0,0 +1,241 @@
+#ifndef components_hpp
+#define components_hpp
+
+/*
+ Connected components (weakly connected, for digraphs:  edges count in
+ either direction).
+
+ connectedComponents() is Afforest (Sutton, Ben-Nun and Barak) over a
+ lock-free Shiloach-Vishkin union-find:  comp[v] points towards v's
+ root, linking hooks the larger root under the smaller one with a
+ compare and swap, and compression shortcuts the pointers.  First every
+ vertex is linked to its first SAMPLE neighbors only, which on most
+ graphs already settles the giant component;  the most frequent root
+ among a random sample of vertices is taken to be it, and the rest of
+ the edges are only processed for vertices outside it.  That skip is
+ only valid when every edge is stored both ways (undirected graphs,
+ their csrgraphs):  pass symmetric = false for a digraph and all edges
+ are processed (the algorithm is still linear, just does more work).
+
+ labelPropagation() is the simple fallback:  every vertex repeatedly
+ takes the smallest label among itself and its neighbors, pushing it
+ both ways along each edge, until nothing changes.  It needs O(diameter)
+ passes but no pointer chasing, and doesn't depend on sampling.
+
+ Either way label[v] is v's component, numbered 0, 1, ... in order of
+ the smallest vertex in each, sizes[c] the number of vertices in
+ component c, and the number of components is returned.  Both work
+ over any graph scanNbrs() does (see graphscan.hpp).
+*/
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include "bfs.hpp"
+
+namespace components_detail {
+
+typedef std::vector<std::atomic<int> > comp_t;
+
+// hook the roots of u and v (the larger one under the smaller)
+inline void link(comp_t& comp, int u, int v)
+{
+  int p1 = comp[u].load(std::memory_order_relaxed);
+  int p2 = comp[v].load(std::memory_order_relaxed);
+  while (p1 != p2) {
+    const int high = std::max(p1, p2);
+    const int low = std::min(p1, p2);
+    int ph = comp[high].load(std::memory_order_relaxed);
+    if (ph == low)
+      break;
+    if (ph == high && comp[high].compare_exchange_strong(ph, low))
+      break;
+    p1 = comp[comp[high].load(std::memory_order_relaxed)]
+      .load(std::memory_order_relaxed);
+    p2 = comp[low].load(std::memory_order_relaxed);
+  }
+}
+
+// point every vertex straight at its root (run after all the links)
+inline void compress(comp_t& comp, int lo, int hi)
+{
+  for (int v = lo; v < hi; v++) {
+    int p = comp[v].load(std::memory_order_relaxed);
+    int pp = comp[p].load(std::memory_order_relaxed);
+    while (p != pp) {
+      comp[v].store(pp, std::memory_order_relaxed);
+      p = pp;
+      pp = comp[p].load(std::memory_order_relaxed);
+    }
+  }
+}
+
+// call f(v) for every vertex, the threads claiming chunks of vertices
+template <class F>
+inline void forVerts(int n, std::atomic<int>& pos, F f)
+{
+  const int CHUNK = 256;
+  for (;;) {
+    const int b = pos.fetch_add(CHUNK);
+    if (b >= n)
+      break;
+    const int e = std::min(b + CHUNK, n);
+    for (int v = b; v < e; v++) {
+      f(v);
+    }
+  }
+}
+
+// comp[v] is the smallest vertex of v's component:  number those
+inline int finish(comp_t const& comp, std::vector<int>& label,
+		  std::vector<int>& sizes)
+{
+  const int n = comp.size();
+  label.resize(n);
+  sizes.clear();
+  for (int v = 0; v < n; v++) {
+    const int r = comp[v].load(std::memory_order_relaxed);
+    if (r == v) {
+      label[v] = sizes.size();
+      sizes.push_back(0);
+    }
+    else
+      label[v] = label[r];       // r < v, so already numbered
+    sizes[label[v]]++;
+  }
+  return sizes.size();
+}
+
+} // namespace components_detail
+
+template <class G>
+int connectedComponents(G const& g, std::vector<int>& label,
+			std::vector<int>& sizes, bool symmetric = false,
+			int nthreads = defaultThreads())
+{
+  using namespace components_detail;
+  nthreads = threadCount(nthreads);
+  const int SAMPLE = 2;           // neighbors linked in the first pass
+  const int NPROBE = 1024;        // vertices sampled for the giant root
+  const int n = g.numVerts();
+
+  comp_t comp(n);
+  for (int v = 0; v < n; v++) {
+    comp[v].store(v, std::memory_order_relaxed);
+  }
+  std::atomic<int> pos(0);
+  int giant = -1;                 // root whose vertices are skipped
+  spinBarrier barrier(nthreads);
+
+  parallelRun(nthreads, [&](int tid) {
+    int lo, hi;
+    splitRange(n, nthreads, tid, lo, hi);
+
+    forVerts(n, pos, [&](int v) {
+      int k = 0;
+      scanNbrs(g, v, [&](int w) {
+	link(comp, v, w);
+	return ++k == SAMPLE;
+      });
+    });
+    barrier.wait();
+    compress(comp, lo, hi);
+    barrier.wait();
+
+    if (tid == 0) {
+      if (symmetric && n > 0) {
+	// the most frequent root among NPROBE vertices (a fixed LCG, so
+	// runs repeat)
+	std::vector<int> roots(NPROBE);
+	unsigned x = 12345;
+	for (int i = 0; i < NPROBE; i++) {
+	  x = x * 1103515245u + 12345u;
+	  roots[i] = comp[(x >> 8) % n].load(std::memory_order_relaxed);
+	}
+	std::sort(roots.begin(), roots.end());
+	int best = 0;
+	for (int i = 0, j; i < NPROBE; i = j) {
+	  for (j = i; j < NPROBE && roots[j] == roots[i]; j++)
+	    ;
+	  if (j - i > best) {
+	    best = j - i;
+	    giant = roots[i];
+	  }
+	}
+      }
+      pos.store(0);
+    }
+    barrier.wait();
+
+    forVerts(n, pos, [&](int v) {
+      if (comp[v].load(std::memory_order_relaxed) == giant)
+	return;
+      int k = 0;
+      scanNbrs(g, v, [&](int w) {
+	if (k++ >= SAMPLE)
+	  link(comp, v, w);
+	return false;
+      });
+    });
+    barrier.wait();
+    compress(comp, lo, hi);
+  });
+
+  return finish(comp, label, sizes);
+}
+
+template <class G>
+int labelPropagation(G const& g, std::vector<int>& label,
+		     std::vector<int>& sizes, int nthreads = defaultThreads())
+{
+  using namespace components_detail;
+  nthreads = threadCount(nthreads);
+  const int n = g.numVerts();
+
+  comp_t comp(n);
+  for (int v = 0; v < n; v++) {
+    comp[v].store(v, std::memory_order_relaxed);
+  }
+  std::atomic<int> pos(0);
+  std::atomic<bool> changed(true);
+  spinBarrier barrier(nthreads);
+
+  // atomic min of c into comp[v]
+  auto lower = [&](int v, int c) {
+    int old = comp[v].load(std::memory_order_relaxed);
+    while (c < old) {
+      if (comp[v].compare_exchange_weak(old, c)) {
+	changed.store(true, std::memory_order_relaxed);
+	return;
+      }
+    }
+  };
+
+  parallelRun(nthreads, [&](int tid) {
+    while (changed.load()) {
+      barrier.wait();
+      if (tid == 0) {
+	changed.store(false);
+	pos.store(0);
+      }
+      barrier.wait();
+      forVerts(n, pos, [&](int v) {
+	scanNbrs(g, v, [&](int w) {
+	  const int cv = comp[v].load(std::memory_order_relaxed);
+	  const int cw = comp[w].load(std::memory_order_relaxed);
+	  if (cw < cv)
+	    lower(v, cw);
+	  else if (cv < cw)
+	    lower(w, cv);
+	  return false;
+	});
+      });
+      barrier.wait();
+    }
+  });
+
+  return finish(comp, label, sizes);
+}
+
+#endif // components_hpp
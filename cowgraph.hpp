@@ -0,0 +1,240 @@
+#ifndef cowgraph_hpp
+#define cowgraph_hpp
+
+/*
+ A digraph whose versions share storage (copy on write).  Vertices are
+ grouped in blocks of BLOCK consecutive ids;  each block (the edge lists
+ of its vertices) is reference counted, and copying a cowgraph (or
+ snapshot()) only copies the block pointers.  An edit clones the one
+ block it touches if some other version still uses it, so a snapshot
+ followed by a small edit costs O(V/BLOCK + edges of a block) instead
+ of a copy of the whole graph, and unchanged blocks are kept once no
+ matter how many versions refer to them:
+
+   cowgraph<int> g(digraph);
+   cowgraph<int> v1 = g.snapshot();
+   g.addEdge(3, 7, 1);          // clones block 0 only;  v1 unchanged
+
+ Edit through addEdge()/setEdge()/delEdge()/delOutEdges() only (there
+ is no non-const operator[], which would bypass the sharing).  thaw()
+ turns a version back into a plain digraph, freeze() into a csrgraph.
+
+ Whether a block may be edited in place is not read off its reference
+ count (use_count() is only a relaxed estimate across threads):  every
+ version has an id, unique for the life of the program, and every block
+ records the id of the version that created it.  A version edits in
+ place only the blocks carrying its own id;  copying a version gives
+ both the copy and the original fresh ids, so from then on neither
+ owns the blocks they share and each clones before writing.  So
+ different versions may be edited by different threads, but any one
+ version (including making copies of it) by only one thread at a time.
+*/
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "digraph.hpp"
+
+template <class T, class S = defaultEdges, class A = std::allocator<char> >
+class cowgraph {
+public:
+  typedef edgeContainer<T, S, A> umapEdge;
+  typedef typename umapEdge::iterator iterator;
+  typedef typename umapEdge::const_iterator const_iterator;
+  typedef A allocator_type;
+
+  enum { BLOCK = 64 };        // vertices per shared block
+
+  explicit cowgraph(int nverts = 0, A const& alloc = A());
+  explicit cowgraph(digraph<T, S, A> const& g);   // (copies g's edges)
+  cowgraph(cowgraph const& g);       // shares g's blocks (see above)
+  cowgraph& operator=(cowgraph const& g);
+
+  // a version sharing every block with this one (as does a copy)
+  cowgraph snapshot() const { return *this; }
+
+  int numVerts() const { return m_nverts; }
+  int numEdges() const { return m_nedges; }
+  int addVertex();            // add a vertex with no edges
+
+  umapEdge const& adj(int src) const
+    { return m_blocks[src / BLOCK]->adj[src % BLOCK]; }
+  umapEdge const& operator[] (int src) const { return adj(src); }
+  const_iterator findEdge(int src, int dst) const
+    { return adj(src).find(dst); }
+
+  // as in digraph:  add src -> dst unless present.  setEdge() also
+  // overwrites the edge information of an existing edge.  each returns
+  // true if the edge is new.  no block is cloned when nothing changes
+  bool addEdge(int src, int dst, T const& e);
+  bool setEdge(int src, int dst, T const& e);
+  bool delEdge(int src, int dst);
+  void delOutEdges(int src);
+
+  // storage sharing:  blocks of this version, and how many of them are
+  // also used by some other version (a statistic:  the count is only
+  // exact while no other thread copies or drops versions)
+  int numBlocks() const { return m_blocks.size(); }
+  int numSharedBlocks() const;
+
+  digraph<T, S, A> thaw() const;     // an independent plain digraph
+  csrgraph<T> freeze() const { return csrgraph<T>(*this); }
+private:
+  struct block {
+    unsigned long long owner;        // id of the version that made it
+    std::vector<umapEdge> adj;       // edge lists of BLOCK vertices
+  };
+
+  static unsigned long long newId();
+  umapEdge& mutableAdj(int src);     // clones src's block unless owned
+
+  std::vector<std::shared_ptr<block> > m_blocks;
+  mutable unsigned long long m_id;   // (renewed by copies, see above)
+  int m_nverts;
+  int m_nedges;
+  A   m_alloc;
+};
+
+template <class T, class S, class A>
+inline cowgraph<T, S, A>::cowgraph(int nverts, A const& alloc)
+  : m_id(newId()), m_nverts(0), m_nedges(0), m_alloc(alloc)
+{
+  for (int v = 0; v < nverts; v++) {
+    addVertex();
+  }
+}
+
+template <class T, class S, class A>
+inline cowgraph<T, S, A>::cowgraph(digraph<T, S, A> const& g)
+  : m_id(newId()), m_nverts(0), m_nedges(g.numEdges()),
+    m_alloc(g.get_allocator())
+{
+  for (int v = 0; v < g.numVerts(); v++) {
+    addVertex();
+    m_blocks.back()->adj.back() = g.adj(v);
+  }
+}
+
+template <class T, class S, class A>
+inline cowgraph<T, S, A>::cowgraph(cowgraph const& g)
+  : m_blocks(g.m_blocks), m_id(newId()), m_nverts(g.m_nverts),
+    m_nedges(g.m_nedges), m_alloc(g.m_alloc)
+{
+  g.m_id = newId();             // g no longer owns what it shares
+}
+
+template <class T, class S, class A>
+inline cowgraph<T, S, A>& cowgraph<T, S, A>::operator=(cowgraph const& g)
+{
+  if (this != &g) {
+    m_blocks = g.m_blocks;
+    m_id = newId();
+    g.m_id = newId();
+    m_nverts = g.m_nverts;
+    m_nedges = g.m_nedges;
+    m_alloc = g.m_alloc;
+  }
+  return *this;
+}
+
+template <class T, class S, class A>
+inline unsigned long long cowgraph<T, S, A>::newId()
+{
+  static std::atomic<unsigned long long> next(1);
+  return next.fetch_add(1);
+}
+
+template <class T, class S, class A>
+inline int cowgraph<T, S, A>::addVertex()
+{
+  if (m_nverts % BLOCK == 0) {
+    m_blocks.push_back(std::make_shared<block>());
+    m_blocks.back()->owner = m_id;
+    m_blocks.back()->adj.reserve(BLOCK);
+    m_blocks.back()->adj.push_back(umapEdge(m_alloc));
+    return m_nverts++;
+  }
+  mutableAdj(m_nverts - 1);     // (makes the last block ours)
+  m_blocks.back()->adj.push_back(umapEdge(m_alloc));
+  return m_nverts++;
+}
+
+template <class T, class S, class A>
+inline typename cowgraph<T, S, A>::umapEdge&
+cowgraph<T, S, A>::mutableAdj(int src)
+{
+  std::shared_ptr<block>& b = m_blocks[src / BLOCK];
+  if (b->owner != m_id) {       // copy on write
+    std::shared_ptr<block> mine = std::make_shared<block>(*b);
+    mine->owner = m_id;
+    b = mine;
+  }
+  return b->adj[src % BLOCK];
+}
+
+template <class T, class S, class A>
+inline bool cowgraph<T, S, A>::addEdge(int src, int dst, T const& e)
+{
+#ifdef _DEBUG
+  if (src >= numVerts() || dst >= numVerts())
+    throw std::out_of_range("addEdge() src/dst");
+#endif
+  if (adj(src).find(dst) != adj(src).end())
+    return false;
+  mutableAdj(src).insert(typename umapEdge::value_type(dst, e));
+  m_nedges++;
+  return true;
+}
+
+template <class T, class S, class A>
+inline bool cowgraph<T, S, A>::setEdge(int src, int dst, T const& e)
+{
+  const_iterator it = findEdge(src, dst);
+  if (it == adj(src).end())
+    return addEdge(src, dst, e);
+  if (!(it->second == e))
+    mutableAdj(src).find(dst)->second = e;
+  return false;
+}
+
+template <class T, class S, class A>
+inline bool cowgraph<T, S, A>::delEdge(int src, int dst)
+{
+  if (adj(src).find(dst) == adj(src).end())
+    return false;
+  mutableAdj(src).erase(dst);
+  m_nedges--;
+  return true;
+}
+
+template <class T, class S, class A>
+inline void cowgraph<T, S, A>::delOutEdges(int src)
+{
+  if (adj(src).size() == 0)
+    return;
+  m_nedges -= adj(src).size();
+  mutableAdj(src).clear();
+}
+
+template <class T, class S, class A>
+inline int cowgraph<T, S, A>::numSharedBlocks() const
+{
+  int n = 0;
+  for (size_t b = 0; b < m_blocks.size(); b++) {
+    n += m_blocks[b].use_count() > 1;
+  }
+  return n;
+}
+
+template <class T, class S, class A>
+inline digraph<T, S, A> cowgraph<T, S, A>::thaw() const
+{
+  digraph<T, S, A> g(numVerts(), m_alloc);
+  for (int v = 0; v < numVerts(); v++) {
+    g[v] = adj(v);
+  }
+  return g;
+}
+
+#endif // cowgraph_hpp
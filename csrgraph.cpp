@@ -0,0 +1,48 @@
+#include <vector>
+#include <string>
+
+#include "strfuncs.hpp"
+#include "digraph.hpp"
+#include "graphout.hpp"
+
+using std::vector;
+using std::string;
+
+// the traversal and the exporters are shared with digraph (bfs.hpp,
+// graphout.hpp);  they read the neighbor arrays directly
+template <class T>
+void csrgraph<T>::bfs(int src, vector<int>& parent) const
+{
+  bfsTree(*this, src, parent);
+}
+
+template <class T>
+string csrgraph<T>::toXML() const
+{
+  return graphToXML(*this);
+}
+
+template <class T>
+string csrgraph<T>::toDIMACS(int src, int dst) const
+{
+  return graphToDIMACS<T>(*this, src, dst);
+}
+
+template <class T>
+string csrgraph<T>::toAdjMat() const
+{
+  return graphToAdjMat<T>(*this);
+}
+
+// explicit member function template instantiation for ints
+template void csrgraph<int>::bfs(int src, vector<int>& parent) const;
+template string csrgraph<int>::toXML() const;
+template string csrgraph<int>::toDIMACS(int src, int dst) const;
+template string csrgraph<int>::toAdjMat() const;
+
+// ... and for iw_ungraph's 16 bit weights (see iw_ungraph.hpp)
+template void csrgraph<unsigned short>::bfs(int src, vector<int>& parent)
+  const;
+template string csrgraph<unsigned short>::toXML() const;
+template string csrgraph<unsigned short>::toDIMACS(int src, int dst) const;
+template string csrgraph<unsigned short>::toAdjMat() const;
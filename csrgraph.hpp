@@ -0,0 +1,207 @@
+#ifndef csrgraph_hpp
+#define csrgraph_hpp
+
+/*
+ A frozen (read only) compressed sparse row snapshot of a digraph.  The
+ adjacency of vertex v lives in the half open range [m_off[v],
+ m_off[v+1]) of two parallel arrays:  m_nbr (adjacent vertex index)
+ and m_wt (edge information).  Neighbors are kept sorted so findEdge()
+ is a binary search.
+
+ The read only interface mirrors digraph (numVerts(), adj(), findEdge(),
+ it->first, it->second, ...) so traversal code written against a
+ digraph runs unchanged on the frozen form.  Obtain one with
+ digraph<T>::freeze().  NOTE: the snapshot does NOT follow later
+ changes made to the digraph it was frozen from.
+
+ Topology and edge data are kept structure-of-arrays style.  An edge
+ id is the edge's position in the neighbor array (the edges of v are
+ ids offsets()[v] .. offsets()[v+1]-1).  Topology only passes should
+ walk nbrBegin()/nbrEnd() and never touch the edge data;  passes over
+ edge data alone can run straight down weights().  Extra per edge
+ properties go in props() as separate columns indexed by edge id.
+ The topology is frozen, but edge data and property columns are not.
+*/
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "edgeprops.hpp"
+
+template <class T>
+class csrgraph {
+public:
+  // (adjacent vertex, edge information) as seen through an iterator
+  struct edgeRef {
+    int const& first;
+    T const&   second;
+  };
+
+  class const_iterator {
+  public:
+    // operator-> must return something that itself has an operator->
+    struct arrow {
+      edgeRef r;
+      edgeRef const* operator->() const { return &r; }
+    };
+
+    const_iterator() : m_n(0), m_w(0) {}
+    const_iterator(int const* n, T const* w) : m_n(n), m_w(w) {}
+
+    edgeRef operator*() const { edgeRef r = { *m_n, *m_w }; return r; }
+    arrow operator->() const { arrow a = { { *m_n, *m_w } }; return a; }
+
+    const_iterator& operator++() { ++m_n; ++m_w; return *this; }
+    const_iterator operator++(int)
+      { const_iterator t(*this); ++*this; return t; }
+
+    bool operator==(const_iterator const& o) const { return m_n == o.m_n; }
+    bool operator!=(const_iterator const& o) const { return m_n != o.m_n; }
+
+    int const* nbr() const { return m_n; }   // raw topology position
+  private:
+    int const* m_n;
+    T const*   m_w;
+  };
+  typedef const_iterator iterator;
+
+  // the edge list of one vertex (stands in for digraph<T>::umapEdge)
+  class edgeRange {
+  public:
+    edgeRange(int const* n, T const* w, int len)
+      : m_n(n), m_w(w), m_len(len) {}
+
+    const_iterator begin() const { return const_iterator(m_n, m_w); }
+    const_iterator end() const
+      { return const_iterator(m_n + m_len, m_w + m_len); }
+    size_t size() const { return m_len; }
+    bool empty() const { return m_len == 0; }
+
+    // binary search on the sorted neighbors:  iterator to edge or end()
+    const_iterator find(int key) const {
+      int const* p = std::lower_bound(m_n, m_n + m_len, key);
+      if (p == m_n + m_len || *p != key)
+	return end();
+      return const_iterator(p, m_w + (p - m_n));
+    }
+  private:
+    int const* m_n;
+    T const*   m_w;
+    int        m_len;
+  };
+  typedef edgeRange umapEdge;
+
+  csrgraph();
+  template <class G>
+  explicit csrgraph(G const& g);   // freeze any digraph-like graph
+
+  int numVerts() const { return (int) m_off.size() - 1; }
+  int numEdges() const { return m_off.back(); }
+  int outDegree(int src) const { return m_off[src+1] - m_off[src]; }
+
+  edgeRange adj(int src) const;
+  edgeRange operator[] (int src) const { return adj(src); }
+
+  // returns iterator to edge or adj(src).end()
+  const_iterator findEdge(int src, int dst) const;
+
+  // raw access to the three arrays (for tight loops)
+  std::vector<int> const& offsets()   const { return m_off; }
+  std::vector<int> const& neighbors() const { return m_nbr; }
+  std::vector<T>   const& weights()   const { return m_wt; }
+  std::vector<T>&         weights()         { return m_wt; }
+
+  // topology only:  the (sorted) neighbors of src
+  int const* nbrBegin(int src) const { return m_nbr.data() + m_off[src]; }
+  int const* nbrEnd(int src)   const { return m_nbr.data() + m_off[src+1]; }
+
+  // edge id of src -> dst, or -1 if there is no such edge
+  int edgeId(int src, int dst) const;
+
+  // additional edge property columns (all indexed by edge id)
+  edgeProps&       props()       { return m_props; }
+  edgeProps const& props() const { return m_props; }
+
+  // simple graph algorithms (same as digraph versions)
+  void bfs(int src, std::vector<int>& parent) const; // breadth-first search
+
+  // object-to-string conversion routines  (useful for output)
+  std::string toXML() const;                    // convert to XML string
+  std::string toDIMACS(int src, int dst) const; // convert to DIMACS string
+  std::string toAdjMat() const;         // convert to Adjacency Matrix string
+private:
+  // order edges on adjacent vertex only (T need not be comparable)
+  struct byFirst {
+    bool operator()(std::pair<int, T> const& a,
+		    std::pair<int, T> const& b) const {
+      return a.first < b.first;
+    }
+  };
+
+  std::vector<int> m_off;   // numVerts()+1 offsets into m_nbr and m_wt
+  std::vector<int> m_nbr;   // adjacent vertex indices, sorted per vertex
+  std::vector<T>   m_wt;    // edge information parallel to m_nbr
+  edgeProps        m_props; // more per edge columns parallel to m_nbr
+};
+
+template <class T>
+inline csrgraph<T>::csrgraph()
+  : m_off(1, 0)
+{
+}
+
+template <class T>
+template <class G>
+csrgraph<T>::csrgraph(G const& g)
+  : m_off(g.numVerts() + 1, 0)
+{
+  const int n = g.numVerts();
+
+  // first pass:  degrees become offsets (exclusive prefix sum)
+  for (int v = 0; v < n; v++) {
+    m_off[v+1] = m_off[v] + g.adj(v).size();
+  }
+  m_nbr.resize(m_off[n]);
+  m_wt.resize(m_off[n]);
+  m_props = edgeProps(m_off[n]);
+
+  // second pass:  copy each edge list out of the hash map and sort it
+  std::vector<std::pair<int, T> > tmp;
+  for (int v = 0; v < n; v++) {
+    tmp.clear();
+    for (typename G::const_iterator it = g.adj(v).begin();
+	 it != g.adj(v).end(); ++it) {
+      tmp.push_back(std::pair<int, T>(it->first, it->second));
+    }
+    std::sort(tmp.begin(), tmp.end(), byFirst());
+    for (size_t i = 0; i < tmp.size(); i++) {
+      m_nbr[m_off[v] + i] = tmp[i].first;
+      m_wt[m_off[v] + i]  = tmp[i].second;
+    }
+  }
+}
+
+template <class T>
+inline typename csrgraph<T>::edgeRange csrgraph<T>::adj(int src) const
+{
+  const int b = m_off[src];
+  return edgeRange(m_nbr.data() + b, m_wt.data() + b, m_off[src+1] - b);
+}
+
+template <class T>
+inline int csrgraph<T>::edgeId(int src, int dst) const
+{
+  int const* p = std::lower_bound(nbrBegin(src), nbrEnd(src), dst);
+  return (p != nbrEnd(src) && *p == dst) ? p - m_nbr.data() : -1;
+}
+
+template <class T>
+inline typename csrgraph<T>::const_iterator
+csrgraph<T>::findEdge(int src, int dst) const
+{
+  return adj(src).find(dst);
+}
+
+#endif // csrgraph_hpp
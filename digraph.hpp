@@ -13,6 +13,17 @@
 
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <stdexcept>
+
+#include "flatmap.hpp"
+#include "myhash.hpp"
+#include "csrgraph.hpp"
+#include "graphout.hpp"
+#include "memstats.hpp"
+#include "strfuncs.hpp"
 
 // AT() used for bounds checking when debugging
 #ifdef _DEBUG
@@ -31,21 +42,157 @@ public:
 };
 #endif // USE_INT_HASH
 
-template <class T>
-class edgeContainer {
-public:
+/*
+ Edge storage policies.  An edgeContainer keeps its (adjacent vertex,
+ edge information) pairs in S::map<T, A>::type, which must provide the
+ subset of the std::unordered_map interface used below and take the
+ allocator A (rebinding it as needed) in its constructor.
+
+   hashEdges     - std::unordered_map (the original storage)
+   flatEdges<N>  - sorted flat array holding N entries inline, no heap
+                   allocation until a vertex has more than N neighbors
+   myHashEdges   - open addressing (Robin Hood) hash map, keys inline
+
+ The default policy is hashEdges, or myHashEdges if USE_MY_HASH is
+ defined.
+*/
+struct hashEdges {
+  template <class T, class A>
+  struct map {
+    typedef typename std::allocator_traits<A>::template
+      rebind_alloc<std::pair<const int, T> > alloc_t;
 #ifdef USE_INT_HASH
-  typedef std::unordered_map<int, T, intHash> intTmap_t;
+    typedef std::unordered_map<int, T, intHash, std::equal_to<int>,
+			       alloc_t> type;
 #else
-  typedef std::unordered_map<int, T> intTmap_t;
+    typedef std::unordered_map<int, T, std::hash<int>, std::equal_to<int>,
+			       alloc_t> type;
 #endif // USE_INT_HASH
+  };
+};
+
+template <int N = 8>
+struct flatEdges {
+  template <class T, class A>
+  struct map {
+    typedef flatmap<T, N, A> type;
+  };
+};
+
+struct myHashEdges {
+  template <class T, class A>
+  struct map {
+    typedef myhash<T, A> type;
+  };
+};
+
+/*
+ Edge information for topology only graphs, e.g. digraph<noEdgeData,
+ flatEdges<> >.  It is an empty type, and flatEdges storage keeps no
+ values at all for empty types, so an edge costs just its neighbor id.
+ (Narrow types such as unsigned char likewise cost only their own size
+ there, without padding.)  The hash policies store (id, T) pairs, so
+ they still pay for padding.
+*/
+struct noEdgeData {
+  noEdgeData() {}
+  noEdgeData(int) {}     // so T(1) (e.g. addEdge(v, w, 1)) works for any T
+};
+
+inline bool operator==(noEdgeData, noEdgeData) { return true; }
+inline bool operator!=(noEdgeData, noEdgeData) { return false; }
+
+// every edge of a topology only graph has unit weight (e.g. toDIMACS())
+template <>
+inline std::string num2str<noEdgeData>(noEdgeData)
+{
+  return "1";
+}
+
+#ifdef USE_MY_HASH
+typedef myHashEdges defaultEdges;
+#else
+typedef hashEdges defaultEdges;
+#endif // USE_MY_HASH
+
+// add d to every key of an edge map (used to relabel vertex ids):  in
+// general the map has to be rebuilt, but a flatmap stays sorted under
+// a shift, so its keys can simply be bumped in place
+template <class M>
+inline void shiftKeys(M& m, int d)
+{
+  M tmp(m.get_allocator());
+  tmp.reserve(m.size());
+  for (typename M::const_iterator it = m.begin(); it != m.end(); ++it) {
+    tmp.insert(typename M::value_type(it->first + d, it->second));
+  }
+  m = std::move(tmp);
+}
+
+template <class T, int N, class A>
+inline void shiftKeys(flatmap<T, N, A>& m, int d)
+{
+  m.shift(d);
+}
+
+// heap bytes held by an edge map.  for std::unordered_map this is an
+// estimate from its layout:  one node (link + entry) per entry and one
+// pointer per bucket
+template <class M>
+inline size_t mapHeapBytes(M const& m)
+{
+  struct node {
+    void* next;
+    typename M::value_type v;
+  };
+  return m.size() * sizeof(node) + m.bucket_count() * sizeof(void*);
+}
+
+template <class T, int N, class A>
+inline size_t mapHeapBytes(flatmap<T, N, A> const& m)
+{
+  return m.heapBytes();
+}
+
+template <class T, class A>
+inline size_t mapHeapBytes(myhash<T, A> const& m)
+{
+  return m.heapBytes();
+}
+
+// bytes of edge information an edge map keeps per edge:  flatmap
+// stores none for an empty T (e.g. noEdgeData), the others a whole T
+template <class M>
+inline size_t mapValueBytes(M const&)
+{
+  return sizeof(typename M::value_type::second_type);
+}
+
+template <class T, int N, class A>
+inline size_t mapValueBytes(flatmap<T, N, A> const&)
+{
+  return std::is_empty<T>::value ? 0 : sizeof(T);
+}
+
+template <class T, class S = defaultEdges, class A = std::allocator<char> >
+class edgeContainer {
+public:
+  typedef typename S::template map<T, A>::type intTmap_t;
   typedef typename intTmap_t::iterator iterator;
   typedef typename intTmap_t::const_iterator const_iterator;
   typedef typename std::pair<int, T> value_type;
 
-  edgeContainer();
+  explicit edgeContainer(A const& alloc = A());
   ~edgeContainer();
 
+  // the destructor above would otherwise suppress the (cheap) moves
+  edgeContainer(edgeContainer const& ec) : m_ec(ec.m_ec) {}
+  edgeContainer(edgeContainer&& ec) noexcept : m_ec(std::move(ec.m_ec)) {}
+  edgeContainer& operator=(edgeContainer const& ec)
+    { m_ec = ec.m_ec; return *this; }
+  edgeContainer& operator=(edgeContainer&& ec)
+    { m_ec = std::move(ec.m_ec); return *this; }
+
   iterator       begin()       { return m_ec.begin(); }
   const_iterator begin() const { return m_ec.begin(); }
   iterator       end()         { return m_ec.end(); }
@@ -67,26 +214,31 @@ public:
   void rehash(size_t nbuckets) { m_ec.rehash(nbuckets); }
   void reserve(size_t nbuckets) { m_ec.reserve(nbuckets); }
   float load_factor() const { return m_ec.load_factor(); }
+
+  void shift(int d) { shiftKeys(m_ec, d); }  // add d to every adjacent index
+  size_t heapBytes() const { return mapHeapBytes(m_ec); }
+  size_t valueBytes() const { return mapValueBytes(m_ec); }  // per edge
 private:
   // NOTE:  intHash didn't seem to be any more efficient than std::Hash<int>
+  // NOTE:  for low degree vertices flatEdges<> is much smaller than hashing
   intTmap_t m_ec;
   // NOTE:  pair <int, T> consists of <adjacent vertex index, edge information>
   //        the edge information, in simplest case (int), is a WEIGHT
 };
 
-template <class T>
-inline edgeContainer<T>::edgeContainer()
+template <class T, class S, class A>
+inline edgeContainer<T, S, A>::edgeContainer(A const& alloc)
 /*
   : m_ec(7, std::hash<int>(), std::equal_to<int>(),
 	 std::allocator<std::pair<int, T> >())
 */
 //  : m_ec(31) // number of buckets (I think 7 or 11 is the default)
-  : m_ec()
+  : m_ec(typename intTmap_t::allocator_type(alloc))
 {
 }
 
-template <class T>
-inline edgeContainer<T>::~edgeContainer()
+template <class T, class S, class A>
+inline edgeContainer<T, S, A>::~edgeContainer()
 {
 #ifdef HASH_STATS
   static int count;
@@ -102,32 +254,66 @@ inline edgeContainer<T>::~edgeContainer()
 #endif // HASH_STATS
 }
 
-// T is our edge data (possibly a class)
-template <class T>
+// T is our edge data (possibly a class), S is the edge storage policy
+// and A the allocator all edge storage comes from (see arena.hpp)
+template <class T, class S = defaultEdges, class A = std::allocator<char> >
 class digraph {
 public:
   // emapEdge is a map of (destination, T)
-  typedef edgeContainer<T> umapEdge;
+  typedef edgeContainer<T, S, A> umapEdge;
   // next two for notational convenience in code that follows
   typedef typename umapEdge::iterator iterator;
   typedef typename umapEdge::const_iterator const_iterator;
+
+  // a directed edge record for bulk ingestion with addEdges()
+  struct edge {
+    int src;
+    int dst;
+    T   e;
+    edge() : src(0), dst(0), e() {}
+    edge(int s, int d, T const& w) : src(s), dst(d), e(w) {}
+  };
   
-  explicit digraph(int nverts);     // construct a digraph with nverts
+  typedef A allocator_type;
+
+  // construct a digraph with nverts
+  explicit digraph(int nverts, A const& alloc = A());
   digraph(digraph const& g);        // copy constructor
-  digraph(std::vector<int> const& parent);  // create from parent tree array
+  digraph(digraph&& g);             // move constructor (takes g's edges)
+  digraph& operator=(digraph const& g);
+  digraph& operator=(digraph&& g);
+  // create from parent tree array
+  digraph(std::vector<int> const& parent, A const& alloc = A());
 
   void clear();               // clear out the digraph (vertices)
   int  resize(int nverts);    // resize the digraph (only larger)
+  void reserve(int nverts);   // make room for nverts without reallocating
   int  numVerts() const;      // return number of vertices
   int  numEdges() const;      // return number of edges
+  A    get_allocator() const { return m_alloc; }
 
   // return index of minmimum outdegree node excluding, exclude_list[] nodes
+  // (O(V) a call:  to peel a whole graph use coreNumbers(), kcore.hpp)
   int  minOutDegreeIndex(std::vector<bool> const& include_set) const;
 
   // add, del, or find directed edge from src to dst (with weight w)
   std::pair<iterator, bool> addEdge(int src, int dst, T const& e);
   bool delEdge(int src, int dst);
 
+  // add all edges in [first, last) (a range of edge records) at once:
+  // edges are grouped by src, duplicates dropped (the first one wins,
+  // as with addEdge), and each edge list reserved exactly before any
+  // insertion.  compact shrinks the touched edge lists afterwards.
+  // returns the number of edges actually added
+  template <class EdgeIter>
+  int addEdges(EdgeIter first, EdgeIter last, bool compact = false);
+  // same, but every src must lie in [lo, hi) and only the edge lists of
+  // lo .. hi-1 are touched, so threads may fill disjoint vertex ranges
+  // at the same time (provided the in-edge index is off)
+  template <class EdgeIter>
+  int addEdgesRange(EdgeIter first, EdgeIter last, int lo, int hi,
+		    bool compact = false);
+
   // returns iterator to edge or end()
   // NOTE: C++ requires one to indicate which dependent names denote
   //   types by using the typename keyword
@@ -139,15 +325,50 @@ public:
 
   // maybe good to have (u, v) operator instead/in addition to above?
 
+  // optional reverse adjacency (in-edge) index:  while on, addEdge(),
+  // delEdge() and friends keep, for every dst, the set of src's with an
+  // edge src -> dst, so delInEdges() and inDegree() cost O(in-degree)
+  // instead of a scan over all vertices.  NOTE: changing an edge list
+  // through the non-const operator[] bypasses (and breaks) the index
+  typedef edgeContainer<char, S, A> inEdges_t;
+  void trackInEdges(bool on);           // build (true) or drop the index
+  bool tracksInEdges() const { return m_track_in; }
+  inEdges_t const& inAdj(int dst) const;    // requires tracksInEdges()
+  int  inDegree(int dst) const;
+
   void delInEdges(int src);   // delete ALL IN directed edges to src
   void delOutEdges(int src);  // delete ALL OUT emanating edges from src
   //void zeroOutEdges(int src); // zeros ALL OUT emanating edges from src
 
-  int addVertex(int v);
+  int addVertex(int v);       // add a copy of v (same adjacent vertices)
+  int addVertex();            // add a vertex with no edges
+
+  // renumber vertices:  old vertex v becomes old2new[v], or is dropped
+  // (with all its edges) if old2new[v] is -1.  new ids must be distinct
+  // and in [0, nverts), where nverts is the new number of vertices
+  void relabel(std::vector<int> const& old2new, int nverts);
+  // drop every vertex without edges (in or out), renumbering the rest
+  // densely in their old order.  returns new2old (new id -> old id)
+  std::vector<int> compact();
+
+  // vertex orderings that put neighbors close together in memory.  each
+  // returns perm (old id -> new id) for relabel(perm, numVerts()).
+  // every component is covered; bfsOrder() starts with src's
+  std::vector<int> bfsOrder(int src = 0) const;   // breadth-first order
+  std::vector<int> rcmOrder() const;              // reverse Cuthill-McKee
 
   // simple graph algorithms
   void bfs(int src, std::vector<int>& parent) const; // breadth-first search
-  void appendGraph(digraph<T> const& g);      // append g to this graph
+
+  // append g to this graph.  with relabel (disjoint union) g's vertex
+  // ids are shifted by numVerts() so g's edges stay among g's vertices;
+  // otherwise edges are copied verbatim.  the rvalue variant moves g's
+  // edge lists rather than copying them (and leaves g empty)
+  void appendGraph(digraph<T, S, A> const& g, bool relabel = true);
+  void appendGraph(digraph<T, S, A>&& g, bool relabel = true);
+
+  // immutable compressed sparse row snapshot for read only traversal
+  csrgraph<T> freeze() const;
 
   // object-to-string conversion routines  (useful for output)
   std::string toXML() const;            // convert to XML string
@@ -156,72 +377,131 @@ public:
   void setNumBuckets(int src, int nbuckets) { (*this)[src].rehash(nbuckets); }
   float load_factor(int src) const { return adj(src).load_factor(); }
 
+  // memory use and hash health of the whole graph (see memstats.hpp).
+  // one pass over the vertices and no allocation beyond the histograms,
+  // so it is fine to poll while the program runs
+  memStats memoryStats() const;
+
   std::string toDIMACS(int src, int dst) const; // convert to DIMACS string
   std::string toDOT(bool label = false) const;  // convert to DOT string
   std::string toAdjMat() const;         // convert to Adjacency Matrix string
 protected:
   void delEdge(int src, const_iterator ditr);
+  void appendInEdges(int base);
+
+  struct byDst {
+    bool operator()(edge const& a, edge const& b) const
+      { return a.dst < b.dst; }
+  };
+
   /*
    NOTE: may want to use a vector of umapEdge POINTERS !!  This way we
    could move around without actually copying.  Would be dynamic, now,
    however, and will need constructors/destructors.
   */
   std::vector<umapEdge> m_adj;    // adjacency unordered map of edges
+  A m_alloc;                      // for the edge lists of new vertices
+
+  bool m_track_in;                // is m_in maintained?
+  std::vector<inEdges_t> m_in;    // m_in[dst] = { src : src -> dst }
 };
 
-template <class T>
-inline digraph<T>::digraph(int nverts)
-  : m_adj(nverts)
+template <class T, class S, class A>
+inline digraph<T, S, A>::digraph(int nverts, A const& alloc)
+  : m_adj(nverts, umapEdge(alloc)), m_alloc(alloc), m_track_in(false)
 {
 }
 
-template <class T>
-inline digraph<T>::digraph(digraph const& g)
-  : m_adj(g.m_adj)
+template <class T, class S, class A>
+inline digraph<T, S, A>::digraph(digraph const& g)
+  : m_adj(g.m_adj), m_alloc(g.m_alloc), m_track_in(g.m_track_in),
+    m_in(g.m_in)
 {
   // following doesn't seem necessary:
   //for (int v = 0; v < numVerts(); v++)
   //  m_adj[v].reserve(g.adj(v).size());
 }
 
+template <class T, class S, class A>
+inline digraph<T, S, A>::digraph(digraph&& g)
+  : m_adj(std::move(g.m_adj)), m_alloc(g.m_alloc), m_track_in(g.m_track_in),
+    m_in(std::move(g.m_in))
+{
+}
+
+template <class T, class S, class A>
+inline digraph<T, S, A>& digraph<T, S, A>::operator=(digraph const& g)
+{
+  m_adj = g.m_adj;
+  m_alloc = g.m_alloc;
+  m_track_in = g.m_track_in;
+  m_in = g.m_in;
+  return *this;
+}
+
+template <class T, class S, class A>
+inline digraph<T, S, A>& digraph<T, S, A>::operator=(digraph&& g)
+{
+  m_adj = std::move(g.m_adj);
+  m_alloc = g.m_alloc;
+  m_track_in = g.m_track_in;
+  m_in = std::move(g.m_in);
+  return *this;
+}
+
 // build a graph from a tree (represented with parent array)
-template <class T>
-inline digraph<T>::digraph(std::vector<int> const& parent)
-  : m_adj(parent.size())
+template <class T, class S, class A>
+inline digraph<T, S, A>::digraph(std::vector<int> const& parent,
+				 A const& alloc)
+  : m_adj(parent.size(), umapEdge(alloc)), m_alloc(alloc), m_track_in(false)
 {
+  std::vector<edge> edges;
+  edges.reserve(parent.size());
   for (unsigned int dst = 0; dst < parent.size(); dst++) {
     int src = parent[dst];
     if (src != -1 && src < (int) parent.size()) {
-      // insert new directed edge:  src -> dst
-      (*this).addEdge(src, dst, T());
+      // new directed edge:  src -> dst
+      edges.push_back(edge(src, dst, T()));
     }
   }
+  addEdges(edges.begin(), edges.end(), true);
 }
 
-template <class T>
-inline void digraph<T>::clear()
+template <class T, class S, class A>
+inline void digraph<T, S, A>::clear()
 {
   m_adj.clear();
+  m_in.clear();
 }
 
-template <class T>
-inline int digraph<T>::resize(int nverts)
+template <class T, class S, class A>
+inline int digraph<T, S, A>::resize(int nverts)
 {
   if (nverts < numVerts())
     return 0;    // smaller digraph invalidates existing adjacency list
 
-  m_adj.resize(nverts);
+  m_adj.resize(nverts, umapEdge(m_alloc));
+  if (m_track_in)
+    m_in.resize(nverts, inEdges_t(m_alloc));
   return 1;
 }
 
-template <class T>
-inline int digraph<T>::numVerts() const
+template <class T, class S, class A>
+inline void digraph<T, S, A>::reserve(int nverts)
+{
+  m_adj.reserve(nverts);
+  if (m_track_in)
+    m_in.reserve(nverts);
+}
+
+template <class T, class S, class A>
+inline int digraph<T, S, A>::numVerts() const
 {
   return m_adj.size();
 }
 
-template <class T>
-inline int digraph<T>::numEdges() const
+template <class T, class S, class A>
+inline int digraph<T, S, A>::numEdges() const
 {
   int m = 0;
   for (int v = 0; v < numVerts(); v++) {
@@ -231,9 +511,9 @@ inline int digraph<T>::numEdges() const
 }
 
 // include_set is (should be) the same size as m_adj[]
-template <class T>
-inline int digraph<T>::minOutDegreeIndex(std::vector<bool> const& include_set)
-  const
+template <class T, class S, class A>
+inline int
+digraph<T, S, A>::minOutDegreeIndex(std::vector<bool> const& include_set) const
 {
   unsigned int m = numVerts();      // minimum out degree
   int ndx = -1;                     // minimum out degree index
@@ -248,38 +528,40 @@ inline int digraph<T>::minOutDegreeIndex(std::vector<bool> const& include_set)
 }
 
 // return iterator to edge if successful; otherwise adj(src).end()
-template <class T>
-inline typename digraph<T>::const_iterator
-digraph<T>::findEdge(int src, int dst) const
+template <class T, class S, class A>
+inline typename digraph<T, S, A>::const_iterator
+digraph<T, S, A>::findEdge(int src, int dst) const
 {
   return adj(src).find(dst);
 }
 
-template <class T>
-inline typename digraph<T>::umapEdge const& digraph<T>::adj(int src) const
+template <class T, class S, class A>
+inline typename digraph<T, S, A>::umapEdge const&
+digraph<T, S, A>::adj(int src) const
 {
   return m_adj.AT(src);
 }
 
-template <class T>
-inline typename digraph<T>::umapEdge const& digraph<T>::operator[] (int src)
-  const
+template <class T, class S, class A>
+inline typename digraph<T, S, A>::umapEdge const&
+digraph<T, S, A>::operator[] (int src) const
 {
   return m_adj.AT(src);
 }
 
 // non-const variant
-template <class T>
-inline typename digraph<T>::umapEdge& digraph<T>::operator[] (int src)
+template <class T, class S, class A>
+inline typename digraph<T, S, A>::umapEdge&
+digraph<T, S, A>::operator[] (int src)
 {
   return m_adj.AT(src);
 }
 
 // add weighted directed edge from src -> dst:
 //   return true if successful; otherwise false
-template <class T>
-inline std::pair<typename digraph<T>::iterator, bool>
-digraph<T>::addEdge(int src, int dst, T const& e)
+template <class T, class S, class A>
+inline std::pair<typename digraph<T, S, A>::iterator, bool>
+digraph<T, S, A>::addEdge(int src, int dst, T const& e)
 {
 #ifdef _DEBUG
   // AT() doesn't operate on dst for maps.  So, explicitly check for
@@ -289,12 +571,79 @@ digraph<T>::addEdge(int src, int dst, T const& e)
 #endif
 
   // insert new weighted directed edge:  src -> dst
-  return (*this)[src].insert(typename digraph<T>::umapEdge::value_type(dst, e));
+  std::pair<iterator, bool> res =
+    (*this)[src].insert(typename umapEdge::value_type(dst, e));
+  if (m_track_in && res.second)
+    m_in[dst].insert(typename inEdges_t::value_type(src, 0));
+  return res;
+}
+
+template <class T, class S, class A>
+template <class EdgeIter>
+inline int digraph<T, S, A>::addEdges(EdgeIter first, EdgeIter last,
+				      bool compact)
+{
+  return addEdgesRange(first, last, 0, numVerts(), compact);
+}
+
+template <class T, class S, class A>
+template <class EdgeIter>
+int digraph<T, S, A>::addEdgesRange(EdgeIter first, EdgeIter last,
+				    int lo, int hi, bool compact)
+{
+  const int n = hi - lo;
+
+  // count out degrees, then bucket the edges by src (counting sort)
+  std::vector<int> start(n + 1, 0);
+  int m = 0;
+  for (EdgeIter it = first; it != last; ++it, ++m) {
+#ifdef _DEBUG
+    if (it->src < lo || it->src >= hi || it->dst >= numVerts())
+      throw std::out_of_range("addEdges() src/dst");
+#endif
+    start[it->src - lo + 1]++;
+  }
+  for (int v = 0; v < n; v++) {
+    start[v+1] += start[v];
+  }
+
+  std::vector<edge> bysrc(m);
+  std::vector<int> pos(start.begin(), start.end() - 1);
+  for (EdgeIter it = first; it != last; ++it) {
+    bysrc[pos[it->src - lo]++] = *it;
+  }
+
+  int added = 0;
+  for (int i = 0; i < n; i++) {
+    if (start[i] == start[i+1])
+      continue;
+
+    // stable, so the first of any duplicate (v, dst) edges comes first
+    typename std::vector<edge>::iterator b = bysrc.begin() + start[i];
+    typename std::vector<edge>::iterator e = bysrc.begin() + start[i+1];
+    std::stable_sort(b, e, byDst());
+
+    const int v = lo + i;
+    umapEdge& ec = (*this)[v];
+    ec.reserve(ec.size() + (e - b));
+    for (typename std::vector<edge>::iterator it = b; it != e; ++it) {
+      if (it != b && (it-1)->dst == it->dst)
+	continue;   // duplicate within this batch
+      if (ec.insert(typename umapEdge::value_type(it->dst, it->e)).second) {
+	if (m_track_in)
+	  m_in[it->dst].insert(typename inEdges_t::value_type(v, 0));
+	added++;
+      }
+    }
+    if (compact)
+      ec.rehash(0);   // shrink to the smallest size that holds the edges
+  }
+  return added;
 }
 
 // add a vertex with adjacent edges
-template <class T>
-inline int digraph<T>::addVertex(int v)
+template <class T, class S, class A>
+inline int digraph<T, S, A>::addVertex(int v)
 {
   /*
   int pos = numVerts();
@@ -304,7 +653,7 @@ inline int digraph<T>::addVertex(int v)
   std::cout << "before vector capacity = " << m_adj.capacity() << "\n";
   m_adj.push_back(pig);
   std::cout << "after vector capacity = " << m_adj.capacity() << "\n";
-  for (typename digraph<T>::const_iterator it = adj(v).begin();
+  for (typename digraph<T, S, A>::const_iterator it = adj(v).begin();
        it != adj(v).end(); ++it) {
     std::cout << "inserting edge (" << pos << ", " << it->first
 	      << ") with " << it->second << "\n";
@@ -312,58 +661,428 @@ inline int digraph<T>::addVertex(int v)
   }
   */
   m_adj.push_back(adj(v));
+  const int pos = numVerts() - 1;
+  if (m_track_in) {
+    m_in.push_back(inEdges_t(m_alloc));
+    for (const_iterator it = adj(pos).begin(); it != adj(pos).end(); ++it) {
+      m_in[it->first].insert(typename inEdges_t::value_type(pos, 0));
+    }
+  }
+  return pos;   // return position where added
+}
+
+template <class T, class S, class A>
+inline int digraph<T, S, A>::addVertex()
+{
+  m_adj.push_back(umapEdge(m_alloc));
+  if (m_track_in)
+    m_in.push_back(inEdges_t(m_alloc));
   return numVerts() - 1;   // return position where added
 }
 
 // delete directed edge from src -> dst:
 //   return true if successful; otherwise false
-template <class T>
-inline bool digraph<T>::delEdge(int src, int dst)
+template <class T, class S, class A>
+inline bool digraph<T, S, A>::delEdge(int src, int dst)
 {
+  if (m_track_in)
+    m_in[dst].erase(src);
   return (*this)[src].erase(dst) != 0;  // equal_range one element at most
 }
 
-template <class T>
+template <class T, class S, class A>
 inline void
-digraph<T>::delEdge(int src, typename digraph<T>::const_iterator ditr)
+digraph<T, S, A>::delEdge(int src, const_iterator ditr)
 {
+  if (m_track_in)
+    m_in[ditr->first].erase(src);
   (*this)[src].erase(ditr);  // equal_range one element at most
 }
 
-template <class T>
-inline void digraph<T>::delInEdges(int src)   // delete ALL IN directed edges
+template <class T, class S, class A>
+inline void digraph<T, S, A>::trackInEdges(bool on)
 {
-  for (typename digraph<T>::const_iterator it = adj(src).begin();
+  m_track_in = on;
+  std::vector<inEdges_t>().swap(m_in);
+  if (!on)
+    return;
+
+  // in-degrees first, so each in-edge list is sized once
+  std::vector<int> indeg(numVerts(), 0);
+  for (int v = 0; v < numVerts(); v++) {
+    for (const_iterator it = adj(v).begin(); it != adj(v).end(); ++it) {
+      indeg[it->first]++;
+    }
+  }
+  m_in.resize(numVerts(), inEdges_t(m_alloc));
+  for (int v = 0; v < numVerts(); v++) {
+    m_in[v].reserve(indeg[v]);
+  }
+  for (int v = 0; v < numVerts(); v++) {
+    for (const_iterator it = adj(v).begin(); it != adj(v).end(); ++it) {
+      m_in[it->first].insert(typename inEdges_t::value_type(v, 0));
+    }
+  }
+}
+
+template <class T, class S, class A>
+inline typename digraph<T, S, A>::inEdges_t const&
+digraph<T, S, A>::inAdj(int dst) const
+{
+  return m_in.AT(dst);
+}
+
+template <class T, class S, class A>
+inline int digraph<T, S, A>::inDegree(int dst) const
+{
+  if (m_track_in)
+    return m_in[dst].size();
+
+  int d = 0;   // no index:  ask every vertex
+  for (int v = 0; v < numVerts(); v++) {
+    d += (findEdge(v, dst) != adj(v).end());
+  }
+  return d;
+}
+
+// NOTE: without the in-edge index this assumes the graph is symmetric
+// (the in-edges of src are the reverses of its out-edges), as is the
+// case for an ungraph.  For a true digraph call trackInEdges(true).
+template <class T, class S, class A>
+inline void digraph<T, S, A>::delInEdges(int src) // delete ALL IN edges
+{
+  if (m_track_in) {
+    for (typename inEdges_t::const_iterator it = m_in[src].begin();
+	 it != m_in[src].end(); ++it) {
+      (*this)[it->first].erase(src);
+    }
+    m_in[src].clear();
+    return;
+  }
+
+  for (typename digraph<T, S, A>::const_iterator it = adj(src).begin();
        it != adj(src).end(); ++it) {
     delEdge(it->first, src);
   }
 }
 
-template <class T>
-inline void digraph<T>::delOutEdges(int src)   // delete ALL OUT emanating edges
+template <class T, class S, class A>
+inline void digraph<T, S, A>::delOutEdges(int src)  // delete ALL OUT edges
 {
+  if (m_track_in) {
+    for (const_iterator it = adj(src).begin(); it != adj(src).end(); ++it) {
+      m_in[it->first].erase(src);
+    }
+  }
   (*this)[src].clear();
 }
 
 // CURRENTLY THIS NEXT ROUTINE NOT USED ANYWHERE
 /*
-template <class T>
-inline void digraph<T>::zeroOutEdges(int src)  // zeroes ALL OUT emanating edges
+template <class T, class S, class A>
+inline void digraph<T, S, A>::zeroOutEdges(int src) // zeroes ALL OUT edges
 {
-  for (typename digraph<T>::iterator it = (*this)[src].begin();
+  for (typename digraph<T, S, A>::iterator it = (*this)[src].begin();
        it != (*this)[src].end(); ++it) {
     it->second = T(0);
   }
 }
 */
 
-template <class T>
-inline void digraph<T>::appendGraph(digraph<T> const& g)
+template <class T, class S, class A>
+inline void digraph<T, S, A>::appendGraph(digraph<T, S, A> const& g,
+					   bool relabel)
 {
+  const int base = numVerts();
   const int n = g.numVerts();   // can't use size in loop because growing
+  reserve(base + n);
   for (int v = 0; v < n; v++) {
     m_adj.push_back(g.adj(v));
+    if (relabel)
+      m_adj.back().shift(base);
+  }
+  appendInEdges(base);
+}
+
+template <class T, class S, class A>
+inline void digraph<T, S, A>::appendGraph(digraph<T, S, A>&& g, bool relabel)
+{
+  if (&g == this) {   // can't steal from ourselves
+    appendGraph(static_cast<digraph<T, S, A> const&>(g), relabel);
+    return;
+  }
+
+  const int base = numVerts();
+  const int n = g.numVerts();
+  reserve(base + n);
+  for (int v = 0; v < n; v++) {
+    m_adj.push_back(std::move(g.m_adj[v]));
+    if (relabel)
+      m_adj.back().shift(base);
+  }
+  appendInEdges(base);
+  g.clear();
+}
+
+template <class T, class S, class A>
+void digraph<T, S, A>::relabel(std::vector<int> const& old2new, int nverts)
+{
+  std::vector<umapEdge> adj2(nverts, umapEdge(m_alloc));
+  for (int v = 0; v < numVerts(); v++) {
+    const int nv = old2new[v];
+    if (nv < 0)
+      continue;
+    umapEdge& ec = adj2[nv];
+    ec.reserve(adj(v).size());
+    for (const_iterator it = adj(v).begin(); it != adj(v).end(); ++it) {
+      const int nw = old2new[it->first];
+      if (nw >= 0)
+	ec.insert(typename umapEdge::value_type(nw, it->second));
+    }
+  }
+  m_adj.swap(adj2);
+
+  if (m_track_in)
+    trackInEdges(true);
+}
+
+template <class T, class S, class A>
+std::vector<int> digraph<T, S, A>::compact()
+{
+  std::vector<bool> active(numVerts(), false);
+  for (int v = 0; v < numVerts(); v++) {
+    if (adj(v).size() > 0)
+      active[v] = true;
+    for (const_iterator it = adj(v).begin(); it != adj(v).end(); ++it) {
+      active[it->first] = true;   // a vertex with only in-edges stays
+    }
+  }
+
+  std::vector<int> old2new(numVerts(), -1);
+  std::vector<int> new2old;
+  for (int v = 0; v < numVerts(); v++) {
+    if (active[v]) {
+      old2new[v] = new2old.size();
+      new2old.push_back(v);
+    }
+  }
+  relabel(old2new, new2old.size());
+  return new2old;
+}
+
+// add the out-edges of vertices base, base+1, ... to the in-edge index
+template <class T, class S, class A>
+inline void digraph<T, S, A>::appendInEdges(int base)
+{
+  if (!m_track_in)
+    return;
+
+  m_in.resize(numVerts(), inEdges_t(m_alloc));
+  for (int v = base; v < numVerts(); v++) {
+    for (const_iterator it = adj(v).begin(); it != adj(v).end(); ++it) {
+      m_in[it->first].insert(typename inEdges_t::value_type(v, 0));
+    }
+  }
+}
+
+template <class T, class S, class A>
+inline csrgraph<T> digraph<T, S, A>::freeze() const
+{
+  return csrgraph<T>(*this);
+}
+
+// perm[v] = position of v in a breadth-first visit starting at src;
+// vertices src can't reach follow, component by component
+template <class T, class S, class A>
+std::vector<int> digraph<T, S, A>::bfsOrder(int src) const
+{
+  const int n = numVerts();
+  std::vector<int> order;   // doubles as the queue
+  order.reserve(n);
+  std::vector<bool> visited(n, false);
+
+  for (int s = src, next = 0; (int) order.size() < n; s = next++) {
+    if (visited[s])
+      continue;
+    visited[s] = true;
+    order.push_back(s);
+    for (size_t head = order.size() - 1; head < order.size(); head++) {
+      int v = order[head];
+      for (typename umapEdge::const_iterator it = adj(v).begin();
+	   it != adj(v).end(); ++it) {
+	if (!visited[it->first]) {
+	  visited[it->first] = true;
+	  order.push_back(it->first);
+	}
+      }
+    }
+  }
+
+  std::vector<int> perm(n);
+  for (int i = 0; i < n; i++) {
+    perm[order[i]] = i;
+  }
+  return perm;
+}
+
+// breadth-first sweep from s over vertices not yet visited:  returns
+// the last level's lowest degree vertex and sets ecc to its distance.
+// dist[] must be all -1 on entry (and is left that way)
+template <class G>
+int farthestVertex(G const& g, int s, std::vector<bool> const& visited,
+		   std::vector<int>& dist, int& ecc)
+{
+  std::vector<int> q(1, s);
+  dist[s] = 0;
+  for (size_t head = 0; head < q.size(); head++) {
+    int v = q[head];
+    for (typename G::const_iterator it = g.adj(v).begin();
+	 it != g.adj(v).end(); ++it) {
+      int w = it->first;
+      if (!visited[w] && dist[w] < 0) {
+	dist[w] = dist[v] + 1;
+	q.push_back(w);
+      }
+    }
+  }
+
+  ecc = dist[q.back()];
+  int best = q.back();
+  for (size_t i = q.size(); i-- > 0 && dist[q[i]] == ecc; ) {
+    if (g.adj(q[i]).size() < g.adj(best).size())
+      best = q[i];
+  }
+  for (size_t i = 0; i < q.size(); i++) {
+    dist[q[i]] = -1;
+  }
+  return best;
+}
+
+/*
+ Reverse Cuthill-McKee.  Each component is visited breadth-first from
+ a pseudo-peripheral vertex (George-Liu:  keep jumping to the far end
+ of a BFS while the eccentricity grows), taking the unvisited
+ neighbors of each vertex in increasing degree order; the reverse of
+ that visit order keeps the adjacency "bandwidth" (max |perm[v] -
+ perm[w]| over edges) small, so neighbors share cache lines and pages.
+*/
+template <class T, class S, class A>
+std::vector<int> digraph<T, S, A>::rcmOrder() const
+{
+  const int n = numVerts();
+  std::vector<int> order;   // Cuthill-McKee order (doubles as the queue)
+  order.reserve(n);
+  std::vector<bool> visited(n, false);
+  std::vector<int> dist(n, -1);
+  std::vector<std::pair<int, int> > nbrs;   // (degree, vertex)
+
+  // components are started in increasing degree order of their vertices
+  std::vector<std::pair<int, int> > bydeg(n);
+  for (int v = 0; v < n; v++) {
+    bydeg[v] = std::pair<int, int>(adj(v).size(), v);
+  }
+  std::sort(bydeg.begin(), bydeg.end());
+
+  for (int i = 0; i < n; i++) {
+    int s = bydeg[i].second;
+    if (visited[s])
+      continue;
+
+    int ecc, ecc2;
+    int t = farthestVertex(*this, s, visited, dist, ecc);
+    for (int tries = 0; tries < 8; tries++) {
+      int u = farthestVertex(*this, t, visited, dist, ecc2);
+      if (ecc2 <= ecc)
+	break;
+      s = t;
+      t = u;
+      ecc = ecc2;
+    }
+    s = t;
+
+    visited[s] = true;
+    order.push_back(s);
+    for (size_t head = order.size() - 1; head < order.size(); head++) {
+      int v = order[head];
+      nbrs.clear();
+      for (typename umapEdge::const_iterator it = adj(v).begin();
+	   it != adj(v).end(); ++it) {
+	int w = it->first;
+	if (!visited[w]) {
+	  visited[w] = true;
+	  nbrs.push_back(std::pair<int, int>(adj(w).size(), w));
+	}
+      }
+      std::sort(nbrs.begin(), nbrs.end());
+      for (size_t k = 0; k < nbrs.size(); k++) {
+	order.push_back(nbrs[k].second);
+      }
+    }
+    // in a digraph the sweep's far end need not reach back to the seed:
+    // start again from the same seed until it is in
+    if (!visited[bydeg[i].second])
+      i--;
+  }
+
+  if ((int) order.size() != n)
+    throw std::logic_error("rcmOrder() missed vertices");
+  std::vector<int> perm(n);
+  for (int i = 0; i < n; i++) {
+    perm[order[i]] = n - 1 - i;
+  }
+  return perm;
+}
+
+// bfs and the exporters are shared with csrgraph (see graphscan.hpp and
+// graphout.hpp)
+template <class T, class S, class A>
+inline void digraph<T, S, A>::bfs(int src, std::vector<int>& parent) const
+{
+  bfsTree(*this, src, parent);
+}
+
+template <class T, class S, class A>
+inline std::string digraph<T, S, A>::toXML() const
+{
+  return graphToXML(*this);
+}
+
+template <class T, class S, class A>
+inline std::string digraph<T, S, A>::toDIMACS(int src, int dst) const
+{
+  return graphToDIMACS<T>(*this, src, dst);
+}
+
+template <class T, class S, class A>
+inline std::string digraph<T, S, A>::toAdjMat() const
+{
+  return graphToAdjMat<T>(*this);
+}
+
+template <class T, class S, class A>
+memStats digraph<T, S, A>::memoryStats() const
+{
+  memStats ms;
+  ms.nverts = numVerts();
+
+  size_t bytes = sizeof(*this) + m_adj.capacity() * sizeof(umapEdge);
+  for (int v = 0; v < numVerts(); v++) {
+    umapEdge const& ec = adj(v);
+    ms.nedges += ec.size();
+    bytes += ec.heapBytes();
+    ms.payload += ec.size() * ec.valueBytes();
+    memStats::count(ms.degree, ec.size());
+    memStats::count(ms.buckets, ec.bucket_count());
+    memStats::countLoad(ms.load, ec.load_factor());
+  }
+  ms.topology = ms.nedges * sizeof(int);
+  ms.overhead = bytes - ms.topology - ms.payload;
+
+  ms.index = m_in.capacity() * sizeof(inEdges_t);
+  for (size_t v = 0; v < m_in.size(); v++) {
+    ms.index += m_in[v].heapBytes();
   }
+  return ms;
 }
 
 #endif // digraph_hpp
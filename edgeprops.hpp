@@ -0,0 +1,154 @@
+#ifndef edgeprops_hpp
+#define edgeprops_hpp
+
+/*
+ Named edge property columns, stored structure-of-arrays style:  each
+ property is its own std::vector indexed by edge id, kept apart from
+ the topology (and from every other property), so a pass over one
+ property streams through exactly that property and nothing else.
+
+ Columns can be added and dropped at run time and may have any
+ (copyable) element type; column<U>(name) must be asked for with the
+ type the column was added with.  Used by csrgraph, whose edge ids are
+ positions in its neighbor array.
+*/
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+class edgeProps {
+public:
+  explicit edgeProps(int nedges = 0) : m_nedges(nedges) {}
+  edgeProps(edgeProps const& p);
+  edgeProps& operator=(edgeProps const& p);
+  ~edgeProps();
+
+  int numEdges() const { return m_nedges; }
+
+  // add a column (every edge set to init);  replaces any of that name
+  template <class U>
+  std::vector<U>& addColumn(std::string const& name, U const& init = U());
+  bool dropColumn(std::string const& name);    // false if no such column
+  bool hasColumn(std::string const& name) const
+    { return m_cols.find(name) != m_cols.end(); }
+  std::vector<std::string> columnNames() const;
+
+  // throws std::out_of_range (no such column) or std::invalid_argument
+  // (column holds some other type)
+  template <class U>
+  std::vector<U>& column(std::string const& name);
+  template <class U>
+  std::vector<U> const& column(std::string const& name) const;
+private:
+  struct columnBase {
+    virtual ~columnBase() {}
+    virtual columnBase* clone() const = 0;
+  };
+
+  template <class U>
+  struct typedColumn : columnBase {
+    typedColumn(int n, U const& init) : data(n, init) {}
+    columnBase* clone() const { return new typedColumn<U>(*this); }
+    std::vector<U> data;
+  };
+
+  typedef std::map<std::string, columnBase*> columns_t;
+
+  void clear();
+  template <class U>
+  typedColumn<U>* find(std::string const& name) const;
+
+  int       m_nedges;
+  columns_t m_cols;
+};
+
+inline edgeProps::edgeProps(edgeProps const& p)
+  : m_nedges(p.m_nedges)
+{
+  *this = p;
+}
+
+inline edgeProps& edgeProps::operator=(edgeProps const& p)
+{
+  if (this != &p) {
+    clear();
+    m_nedges = p.m_nedges;
+    for (columns_t::const_iterator it = p.m_cols.begin();
+	 it != p.m_cols.end(); ++it) {
+      m_cols[it->first] = it->second->clone();
+    }
+  }
+  return *this;
+}
+
+inline edgeProps::~edgeProps()
+{
+  clear();
+}
+
+inline void edgeProps::clear()
+{
+  for (columns_t::iterator it = m_cols.begin(); it != m_cols.end(); ++it) {
+    delete it->second;
+  }
+  m_cols.clear();
+}
+
+template <class U>
+inline std::vector<U>& edgeProps::addColumn(std::string const& name,
+					    U const& init)
+{
+  dropColumn(name);
+  typedColumn<U>* c = new typedColumn<U>(m_nedges, init);
+  m_cols[name] = c;
+  return c->data;
+}
+
+inline bool edgeProps::dropColumn(std::string const& name)
+{
+  columns_t::iterator it = m_cols.find(name);
+  if (it == m_cols.end())
+    return false;
+  delete it->second;
+  m_cols.erase(it);
+  return true;
+}
+
+inline std::vector<std::string> edgeProps::columnNames() const
+{
+  std::vector<std::string> names;
+  for (columns_t::const_iterator it = m_cols.begin();
+       it != m_cols.end(); ++it) {
+    names.push_back(it->first);
+  }
+  return names;
+}
+
+template <class U>
+inline edgeProps::typedColumn<U>* edgeProps::find(std::string const& name)
+  const
+{
+  columns_t::const_iterator it = m_cols.find(name);
+  if (it == m_cols.end())
+    throw std::out_of_range("edgeProps: no column " + name);
+  typedColumn<U>* c = dynamic_cast<typedColumn<U>*>(it->second);
+  if (!c)
+    throw std::invalid_argument("edgeProps: wrong type for column " + name);
+  return c;
+}
+
+template <class U>
+inline std::vector<U>& edgeProps::column(std::string const& name)
+{
+  return find<U>(name)->data;
+}
+
+template <class U>
+inline std::vector<U> const& edgeProps::column(std::string const& name) const
+{
+  return find<U>(name)->data;
+}
+
+#endif // edgeprops_hpp
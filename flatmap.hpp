@@ -0,0 +1,390 @@
+#ifndef flatmap_hpp
+#define flatmap_hpp
+
+/*
+ A small sorted flat map from int to T used as edgeContainer storage
+ (see flatEdges in digraph.hpp).  The first N entries live inside the
+ object itself, so a vertex of degree <= N costs no heap allocation at
+ all; beyond N the entries spill to a heap block that doubles in size.
+ Entries are kept sorted on key, so find() is a binary search and
+ iteration visits neighbors in increasing vertex order.
+
+ Keys and values are kept in two parallel arrays rather than as pairs,
+ so a narrow T (say unsigned char) costs sizeof(T) per entry instead of
+ being padded out to an int, and an empty T (noEdgeData, see
+ digraph.hpp) costs nothing at all:  no values are stored and every
+ entry shares a single T.  Iterators hand out (first, second)
+ references instead of pointers to std::pair.
+
+ The interface is the subset of std::unordered_map that edgeContainer
+ uses.  bucket_count() reports the capacity (one "bucket" per slot).
+ Spill blocks come from (a rebound copy of) the allocator A.
+ NOTE: like a vector, insert() and erase() invalidate iterators.
+*/
+
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+// the inline values of a flatmap:  N T's, or none for an empty T
+template <class T, int N, bool Empty = std::is_empty<T>::value>
+struct flatSlots {
+  T* slots() { return m_vbuf; }
+  T m_vbuf[N];
+};
+
+template <class T, int N>
+struct flatSlots<T, N, true> {
+  T* slots() { static T t; return &t; }
+};
+
+template <class T, int N, class A = std::allocator<char> >
+class flatmap
+  : private std::allocator_traits<A>::template
+      rebind_alloc<char>,                 // (empty base for std::allocator)
+    private flatSlots<T, N> {
+  enum { EMPTY = std::is_empty<T>::value };
+public:
+  typedef std::pair<int, T> value_type;
+  typedef A                 allocator_type;
+
+  // (key, value) as seen through an iterator
+  template <class V>
+  struct entryRef {
+    int const& first;
+    V&         second;
+    operator value_type() const { return value_type(first, second); }
+  };
+
+  template <class V>
+  class iter {
+  public:
+    // operator-> must return something that itself has an operator->
+    struct arrow {
+      entryRef<V> r;
+      entryRef<V> const* operator->() const { return &r; }
+    };
+
+    iter() : m_k(0), m_v(0) {}
+    iter(int const* k, V* v) : m_k(k), m_v(v) {}
+    template <class V2>
+    iter(iter<V2> const& o) : m_k(o.m_k), m_v(o.m_v) {}
+
+    entryRef<V> operator*() const
+      { entryRef<V> r = { *m_k, *m_v }; return r; }
+    arrow operator->() const { arrow a = { { *m_k, *m_v } }; return a; }
+
+    iter& operator++() { ++m_k; if (!EMPTY) ++m_v; return *this; }
+    iter operator++(int) { iter t(*this); ++*this; return t; }
+    bool operator==(iter const& o) const { return m_k == o.m_k; }
+    bool operator!=(iter const& o) const { return m_k != o.m_k; }
+  private:
+    template <class V2> friend class iter;
+    friend class flatmap;
+    int const* m_k;
+    V*         m_v;
+  };
+  typedef iter<T>       iterator;
+  typedef iter<T const> const_iterator;
+
+  explicit flatmap(allocator_type const& a = allocator_type());
+  flatmap(flatmap const& m);
+  flatmap(flatmap&& m) noexcept;
+  flatmap& operator=(flatmap const& m);
+  flatmap& operator=(flatmap&& m);
+  ~flatmap();
+
+  allocator_type get_allocator() const
+    { return allocator_type(static_cast<alloc_t const&>(*this)); }
+
+  iterator       begin()       { return at(0); }
+  const_iterator begin() const { return at(0); }
+  iterator       end()         { return at(m_size); }
+  const_iterator end()   const { return at(m_size); }
+
+  size_t size() const { return m_size; }
+  bool   empty() const { return m_size == 0; }
+
+  iterator       find(int key);
+  const_iterator find(int key) const;
+
+  std::pair<iterator, bool> insert(value_type const& v);
+  T& operator[] (int key)
+    { return insert(value_type(key, T())).first->second; }
+
+  iterator erase(const_iterator it);
+  size_t   erase(int key);
+  void     clear() { m_size = 0; }
+
+  size_t bucket_count() const { return m_cap; }
+  size_t bucket_size(size_t i) const { return i < m_size ? 1 : 0; }
+  float  load_factor() const { return m_size / (float) m_cap; }
+  void   reserve(size_t n) { if (n > m_cap) grow(n); }
+  void   rehash(size_t n);     // n < capacity shrinks (down to size())
+
+  void   shift(int d);         // add d to every key (stays sorted)
+
+  // bytes of the spill block (inline entries are part of the object)
+  size_t heapBytes() const { return m_heap ? blockBytes(m_cap) : 0; }
+private:
+  typedef typename std::allocator_traits<A>::template
+    rebind_alloc<char> alloc_t;
+  typedef std::allocator_traits<alloc_t> traits_t;
+
+  alloc_t& alloc() { return *this; }
+
+  // a spill block of n entries:  n keys, then n values (unless EMPTY)
+  static size_t valOffset(size_t n)
+    { return (n * sizeof(int) + alignof(T) - 1) / alignof(T) * alignof(T); }
+  static size_t blockBytes(size_t n)
+    { return valOffset(n) + (EMPTY ? 0 : n * sizeof(T)); }
+  int* newBlock(size_t n);
+  void deleteBlock(int* p, size_t n);
+
+  int*       keys()       { return m_heap ? m_heap : m_kbuf; }
+  int const* keys() const { return m_heap ? m_heap : m_kbuf; }
+  T*         vals() { return vals(m_heap, m_cap); }
+  T const*   vals() const { return const_cast<flatmap*>(this)->vals(); }
+  T*         vals(int* block, size_t n);
+  T*         val(size_t i) { return vals() + (EMPTY ? 0 : i); }
+
+  iterator       at(size_t i) { return iterator(keys() + i, val(i)); }
+  const_iterator at(size_t i) const
+    { return const_cast<flatmap*>(this)->at(i); }
+  size_t lower_bound(int key) const;
+  void grow(size_t ncap);
+  void copyTo(int* k, T* v) const;   // copy the entries out to k and v
+
+  int*         m_heap;     // spill block (0 while entries fit inline)
+  unsigned int m_size;     // number of entries
+  unsigned int m_cap;      // N while inline, else capacity of m_heap
+  int          m_kbuf[N];  // inline keys (inline values:  flatSlots)
+};
+
+template <class T, int N, class A>
+inline flatmap<T, N, A>::flatmap(allocator_type const& a)
+  : alloc_t(a), m_heap(0), m_size(0), m_cap(N)
+{
+}
+
+template <class T, int N, class A>
+inline flatmap<T, N, A>::flatmap(flatmap const& m)
+  : alloc_t(traits_t::select_on_container_copy_construction(m)),
+    flatSlots<T, N>(), m_heap(0), m_size(0), m_cap(N)
+{
+  *this = m;
+}
+
+template <class T, int N, class A>
+inline flatmap<T, N, A>& flatmap<T, N, A>::operator=(flatmap const& m)
+{
+  if (this != &m) {
+    clear();
+    reserve(m.m_size);
+    m.copyTo(keys(), vals());
+    m_size = m.m_size;
+  }
+  return *this;
+}
+
+// moves steal the spill block;  only inline entries need copying
+template <class T, int N, class A>
+inline flatmap<T, N, A>::flatmap(flatmap&& m) noexcept
+  : alloc_t(m.alloc()), flatSlots<T, N>(),
+    m_heap(m.m_heap), m_size(m.m_size), m_cap(m.m_cap)
+{
+  if (!m_heap)
+    m.copyTo(keys(), vals());
+  m.m_heap = 0;
+  m.m_size = 0;
+  m.m_cap = N;
+}
+
+template <class T, int N, class A>
+inline flatmap<T, N, A>& flatmap<T, N, A>::operator=(flatmap&& m)
+{
+  if (this == &m)
+    return *this;
+  if (!m.m_heap || !(alloc() == m.alloc()))
+    return *this = static_cast<flatmap const&>(m);  // can't steal:  copy
+
+  if (m_heap)
+    deleteBlock(m_heap, m_cap);
+  m_heap = m.m_heap;
+  m_size = m.m_size;
+  m_cap = m.m_cap;
+  m.m_heap = 0;
+  m.m_size = 0;
+  m.m_cap = N;
+  return *this;
+}
+
+template <class T, int N, class A>
+inline flatmap<T, N, A>::~flatmap()
+{
+  if (m_heap)
+    deleteBlock(m_heap, m_cap);
+}
+
+// the values of a spill block of n entries (or the inline ones)
+template <class T, int N, class A>
+inline T* flatmap<T, N, A>::vals(int* block, size_t n)
+{
+  if (EMPTY || !block)
+    return this->slots();
+  return reinterpret_cast<T*>(reinterpret_cast<char*>(block) + valOffset(n));
+}
+
+template <class T, int N, class A>
+inline void flatmap<T, N, A>::copyTo(int* k, T* v) const
+{
+  std::copy(keys(), keys() + m_size, k);
+  if (!EMPTY)
+    std::copy(vals(), vals() + m_size, v);
+}
+
+template <class T, int N, class A>
+inline size_t flatmap<T, N, A>::lower_bound(int key) const
+{
+  int const* k = keys();
+  size_t lo = 0;
+  size_t len = m_size;
+  while (len > 0) {           // hand rolled:  compare on key only
+    size_t half = len / 2;
+    if (k[lo + half] < key) {
+      lo += half + 1;
+      len -= half + 1;
+    }
+    else
+      len = half;
+  }
+  return lo;
+}
+
+template <class T, int N, class A>
+inline typename flatmap<T, N, A>::iterator
+flatmap<T, N, A>::find(int key)
+{
+  size_t i = lower_bound(key);
+  return (i < m_size && keys()[i] == key) ? at(i) : end();
+}
+
+template <class T, int N, class A>
+inline typename flatmap<T, N, A>::const_iterator
+flatmap<T, N, A>::find(int key) const
+{
+  return const_cast<flatmap<T, N, A>*>(this)->find(key);
+}
+
+template <class T, int N, class A>
+inline std::pair<typename flatmap<T, N, A>::iterator, bool>
+flatmap<T, N, A>::insert(value_type const& v)
+{
+  size_t i = lower_bound(v.first);
+  if (i < m_size && keys()[i] == v.first)
+    return std::pair<iterator, bool>(at(i), false);   // already present
+
+  if (m_size == m_cap)
+    grow(2 * m_cap);
+  int* k = keys();
+  std::copy_backward(k + i, k + m_size, k + m_size + 1);   // open a hole
+  k[i] = v.first;
+  if (!EMPTY) {
+    T* w = vals();
+    std::copy_backward(w + i, w + m_size, w + m_size + 1);
+    w[i] = v.second;
+  }
+  m_size++;
+  return std::pair<iterator, bool>(at(i), true);
+}
+
+template <class T, int N, class A>
+inline typename flatmap<T, N, A>::iterator
+flatmap<T, N, A>::erase(const_iterator it)
+{
+  size_t i = it.m_k - keys();
+  int* k = keys();
+  std::copy(k + i + 1, k + m_size, k + i);
+  if (!EMPTY) {
+    T* w = vals();
+    std::copy(w + i + 1, w + m_size, w + i);
+  }
+  m_size--;
+  return at(i);
+}
+
+template <class T, int N, class A>
+inline size_t flatmap<T, N, A>::erase(int key)
+{
+  iterator it = find(key);
+  if (it == end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+template <class T, int N, class A>
+inline void flatmap<T, N, A>::shift(int d)
+{
+  int* k = keys();
+  for (size_t i = 0; i < m_size; i++) {
+    k[i] += d;
+  }
+}
+
+template <class T, int N, class A>
+inline void flatmap<T, N, A>::rehash(size_t n)
+{
+  if (n < m_size)
+    n = m_size;
+  if (n > m_cap)
+    grow(n);
+  else if (n < m_cap && m_heap) {
+    if (n <= (size_t) N) {       // fits inline again:  give back the heap
+      copyTo(m_kbuf, this->slots());
+      deleteBlock(m_heap, m_cap);
+      m_heap = 0;
+      m_cap = N;
+    }
+    else
+      grow(n);
+  }
+}
+
+// move entries into a spill block of (at least) ncap entries
+template <class T, int N, class A>
+inline void flatmap<T, N, A>::grow(size_t ncap)
+{
+  int* p = newBlock(ncap);
+  copyTo(p, vals(p, ncap));
+  if (m_heap)
+    deleteBlock(m_heap, m_cap);
+  m_heap = p;
+  m_cap = ncap;
+}
+
+// spill values are fully constructed, so entries are only ever assigned
+template <class T, int N, class A>
+inline int* flatmap<T, N, A>::newBlock(size_t n)
+{
+  char* p = traits_t::allocate(alloc(), blockBytes(n));
+  if (!EMPTY)
+    std::uninitialized_fill_n(vals(reinterpret_cast<int*>(p), n), n, T());
+  return reinterpret_cast<int*>(p);
+}
+
+template <class T, int N, class A>
+inline void flatmap<T, N, A>::deleteBlock(int* p, size_t n)
+{
+  if (!EMPTY) {
+    T* v = vals(p, n);
+    for (size_t i = 0; i < n; i++) {
+      v[i].~T();
+    }
+  }
+  traits_t::deallocate(alloc(), reinterpret_cast<char*>(p), blockBytes(n));
+}
+
+#endif // flatmap_hpp
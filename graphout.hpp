@@ -0,0 +1,105 @@
+#ifndef graphout_hpp
+#define graphout_hpp
+
+/*
+ The text exporters shared by digraph and csrgraph (their toXML(),
+ toDIMACS() and toAdjMat() members forward here), written once against
+ the scanNbrs()/scanEdges() interface of graphscan.hpp.
+*/
+
+#include <string>
+#include <vector>
+
+#include "strfuncs.hpp"
+#include "graphscan.hpp"
+
+template <class G>
+std::string graphToXML(G const& g)
+{
+  std::string res = "<?xml version=\"1.0\" encoding=\"UTF-8\"?> \n\
+<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\" \n\
+   xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" \n\
+   xsi:schemaLocation=\"http://graphml.graphdrawing.org/xmlns \n\
+   http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">\n";
+
+  res += "  <graph id=\"G\" edgedefault=\"undirected\">\n";
+
+  for (int v = 0; v < g.numVerts(); v++) {
+    res += "    <node id=\"n" + num2str<int>(v) + "\"/>\n";
+  }
+
+  for (int v = 0; v < g.numVerts(); v++) {
+    scanNbrs(g, v, [&](int w) {
+      res += "    <edge source=\"n" + num2str<int>(v)
+	+ "\" target=\"n" + num2str<int>(w) + "\"/>\n";
+      return false;
+    });
+  }
+
+  res += "  </graph>\n";
+  res += "</graphml>\n";
+
+  return res;
+}
+
+// T is the graph's edge information type
+template <class T, class G>
+std::string graphToDIMACS(G const& g, int src, int dst)
+{
+  std::string res = "c toDIMACS()\n";
+  res += "p max     " + num2str<int>(g.numVerts()) + "    "
+    + num2str<int>(g.numEdges()) + "\n";
+  res += "n         " + num2str<int>(src+1) + "  s\n";
+  res += "n         " + num2str<int>(dst+1) + "  t\n";
+
+  for (int v = 0; v < g.numVerts(); v++) {
+    scanEdges(g, v, [&](int w, T const& e) {
+      res += "a       " + num2str<int>(v+1) + "       " + num2str<int>(w+1)
+	+ "       " + num2str<T>(e) + "\n";
+    });
+  }
+
+  return res;
+}
+
+template <class T, class G>
+std::string graphToAdjMat(G const& g)
+{
+  const int n = g.numVerts();
+  std::string res;
+
+  if (n < 1)   // after this point, we have at least a 1 x 1 matrix
+    return res;
+
+  // each row is spread out over a scratch row first (O(n) per row, for
+  // any edge order).  a missing edge is the literal -1, not T(-1):  for
+  // unsigned T that would be a large number, for noEdgeData it would
+  // read as an edge
+  std::vector<T> row(n);
+  std::vector<char> has(n, 0);
+  std::vector<int> touched;
+  res = "[";
+  for (int v = 0; v < n; v++) {
+    res += (v == 0) ? "[" : ",\n[";
+    scanEdges(g, v, [&](int w, T const& e) {
+      row[w] = e;
+      has[w] = 1;
+      touched.push_back(w);
+    });
+    for (int w = 0; w < n; w++) {
+      if (w > 0)
+	res += ",";
+      res += has[w] ? num2str<T>(row[w]) : std::string("-1");
+    }
+    for (size_t i = 0; i < touched.size(); i++) {
+      has[touched[i]] = 0;
+    }
+    touched.clear();
+    res += ']';
+  }
+  res += "]\n";
+
+  return res;
+}
+
+#endif // graphout_hpp
@@ -0,0 +1,90 @@
+#ifndef graphscan_hpp
+#define graphscan_hpp
+
+/*
+ The neighbor and edge scans every traversal in this directory is
+ written against (bfs.hpp, graphout.hpp, sssp.hpp, ...), and the plain
+ BFS built on them.  They work over anything with a const_iterator and
+ adj(v) (digraph/ungraph, cowgraph) and over csrgraph's raw arrays
+ (bitgraph.hpp adds overloads that walk its bit rows).
+ Kept apart from bfs.hpp so digraph.hpp can use them:  bfs.hpp
+ includes digraph.hpp, this header doesn't.
+*/
+
+#include <vector>
+
+#include "csrgraph.hpp"
+
+// call f(w) for each neighbor w of v until f returns true;  returns
+// whether some call did.  csrgraph's neighbors are a plain int array
+template <class G, class F>
+inline bool scanNbrs(G const& g, int v, F f)
+{
+  for (typename G::const_iterator it = g.adj(v).begin();
+       it != g.adj(v).end(); ++it) {
+    if (f(it->first))
+      return true;
+  }
+  return false;
+}
+
+template <class T, class F>
+inline bool scanNbrs(csrgraph<T> const& g, int v, F f)
+{
+  for (int const* w = g.nbrBegin(v); w != g.nbrEnd(v); ++w) {
+    if (f(*w))
+      return true;
+  }
+  return false;
+}
+
+// call f(w, weight) for each edge v -> w (csrgraph:  from its raw arrays)
+template <class G, class F>
+inline void scanEdges(G const& g, int v, F f)
+{
+  for (typename G::const_iterator it = g.adj(v).begin();
+       it != g.adj(v).end(); ++it) {
+    f(it->first, it->second);
+  }
+}
+
+template <class T, class F>
+inline void scanEdges(csrgraph<T> const& g, int v, F f)
+{
+  int const* nbr = g.neighbors().data();
+  T const* wt = g.weights().data();
+  for (int e = g.offsets()[v]; e < g.offsets()[v+1]; e++) {
+    f(nbr[e], wt[e]);
+  }
+}
+
+// plain queue based BFS (what digraph<T>::bfs() and csrgraph<T>::bfs()
+// run):  parent[v] is v's parent in the BFS tree, -1 for src and
+// unreached vertices
+template <class G>
+void bfsTree(G const& g, int src, std::vector<int>& parent)
+{
+  parent.clear();
+  parent.resize(g.numVerts(), -1);   // size = num verts and init to -1
+
+  std::vector<int> q;                // every vertex is pushed at most once
+  q.reserve(g.numVerts());
+  std::vector<bool> visited(g.numVerts(), false);
+
+  q.push_back(src);   // start off with src vertex
+  visited[src] = true;
+  for (size_t head = 0; head < q.size(); head++) {
+    const int v = q[head];
+    // for each vertex, w, adjacent to vertex v do...
+    scanNbrs(g, v, [&](int w) {
+      if (!visited[w]) {
+	visited[w] = true;
+	parent[w] = v;
+	q.push_back(w);
+      }
+      return false;
+    });
+  }
+}
+
+#endif // graphscan_hpp
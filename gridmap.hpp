@@ -0,0 +1,147 @@
+#ifndef gridmap_hpp
+#define gridmap_hpp
+
+/*
+ Maps between the cells of a width x height grid and the dense vertex
+ ids of a graph embedded in it.  Graph builders work in cell numbers
+ (cell = row*width + col), but only some cells end up with edges, so
+ only those get an id (0, 1, ...) and any storage at all:  the cell ->
+ id direction is a hash map, not a width*height array.  Cell numbers
+ are 64 bit, so grids far bigger than memory (up to 2^64 cells) are
+ fine as long as the touched cells fit.
+
+ Ids are handed out as a builder touches cells (insert();  main.cpp's
+ sierpinski builder does this), or all at once from an id -> cell
+ vector.  They can then be renumbered for locality:  hilbertOrder()
+ gives a permutation that the graph (digraph::relabel()) and the map
+ (permute()) are both put through.  Either way a gridmap answers both
+ "which cell is vertex id?" and "which vertex is cell (row, col)?".
+ Vertex ids stay int:  they count touched cells only.
+*/
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+
+typedef unsigned long long cell_t;   // cell number:  row*width + col
+
+class gridmap {
+public:
+  gridmap() : m_width(0), m_height(0) {}
+  gridmap(cell_t width, cell_t height);     // no cells touched yet
+  template <class C>
+  gridmap(cell_t width, cell_t height, std::vector<C> const& id2cell);
+
+  int    numIds() const { return m_cell.size(); }
+  cell_t width()  const { return m_width; }
+  cell_t height() const { return m_height; }
+
+  // id of cell, giving it the next id if it has none yet
+  int insert(cell_t cell);
+
+  // vertex id -> cell, row and column
+  cell_t cell(int id) const { return m_cell[id]; }
+  cell_t row(int id)  const { return m_cell[id] / m_width; }
+  cell_t col(int id)  const { return m_cell[id] % m_width; }
+
+  // cell -> vertex id (-1 for a cell without a vertex)
+  int id(cell_t cell) const;
+  int id(cell_t row, cell_t col) const { return id(row*m_width + col); }
+
+  // renumber ids:  old id becomes perm[id] (e.g. after a reordering)
+  void permute(std::vector<int> const& perm);
+
+  // perm (old id -> new id) that numbers the vertices in the order a
+  // Hilbert curve passes through their cells, so cells that are close
+  // on the grid get close ids.  use with digraph::relabel() & permute()
+  std::vector<int> hilbertOrder() const;
+private:
+  cell_t m_width;
+  cell_t m_height;
+  std::vector<cell_t> m_cell;              // id -> cell
+  std::unordered_map<cell_t, int> m_id;    // touched cell -> id
+};
+
+inline gridmap::gridmap(cell_t width, cell_t height)
+  : m_width(width), m_height(height)
+{
+}
+
+template <class C>
+inline gridmap::gridmap(cell_t width, cell_t height,
+			std::vector<C> const& id2cell)
+  : m_width(width), m_height(height),
+    m_cell(id2cell.begin(), id2cell.end())
+{
+  m_id.reserve(numIds());
+  for (int i = 0; i < numIds(); i++) {
+    m_id[m_cell[i]] = i;
+  }
+}
+
+inline int gridmap::insert(cell_t cell)
+{
+  std::pair<std::unordered_map<cell_t, int>::iterator, bool> res =
+    m_id.insert(std::make_pair(cell, (int) m_cell.size()));
+  if (res.second)
+    m_cell.push_back(cell);
+  return res.first->second;
+}
+
+inline int gridmap::id(cell_t cell) const
+{
+  std::unordered_map<cell_t, int>::const_iterator it = m_id.find(cell);
+  return it == m_id.end() ? -1 : it->second;
+}
+
+inline void gridmap::permute(std::vector<int> const& perm)
+{
+  std::vector<cell_t> cell(numIds());
+  for (int i = 0; i < numIds(); i++) {
+    cell[perm[i]] = m_cell[i];
+    m_id[m_cell[i]] = perm[i];
+  }
+  m_cell.swap(cell);
+}
+
+// distance of (x, y) along the Hilbert curve filling an n x n square
+// (n a power of 2, at most 2^32)
+inline unsigned long long hilbertIndex(cell_t n, cell_t x, cell_t y)
+{
+  unsigned long long d = 0;
+  for (cell_t s = n / 2; s > 0; s /= 2) {
+    cell_t rx = (x & s) > 0;
+    cell_t ry = (y & s) > 0;
+    d += s * s * ((3 * rx) ^ ry);
+    if (ry == 0) {           // rotate the quadrant
+      if (rx == 1) {
+	x = s - 1 - x;
+	y = s - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+inline std::vector<int> gridmap::hilbertOrder() const
+{
+  cell_t n = 1;
+  while (n < m_width || n < m_height)
+    n *= 2;
+
+  std::vector<std::pair<unsigned long long, int> > key(numIds());
+  for (int i = 0; i < numIds(); i++) {
+    key[i] = std::make_pair(hilbertIndex(n, col(i), row(i)), i);
+  }
+  std::sort(key.begin(), key.end());
+
+  std::vector<int> perm(numIds());
+  for (int i = 0; i < numIds(); i++) {
+    perm[key[i].second] = i;
+  }
+  return perm;
+}
+
+#endif // gridmap_hpp
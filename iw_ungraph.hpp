@@ -2,21 +2,29 @@
 #define iw_ungraph_hpp
 
 // iw_ungraph stands for integer weighted undirected graph.
+// Our sierpinski graphs have degree <= 4, so edges are kept in flat
+// (inline) storage rather than in a hash map per vertex.  The weights
+// are recursion depths (<= 40), so a 16 bit weight is plenty, and flat
+// storage keeps it unpadded.  Sums of weights need not fit, though:
+// path lengths are computed wider (sssp.hpp), and delDeg12Nodes() leaves
+// a chain alone rather than let its contracted weight wrap.
 
 #include "ungraph.hpp"
 
-class iw_ungraph : public ungraph<int> {
+typedef unsigned short iw_weight_t;
+
+class iw_ungraph : public ungraph<iw_weight_t, flatEdges<> > {
 public:
+  typedef iw_weight_t weight_t;
+
   explicit iw_ungraph(int nverts);
 
   std::string toDOT(bool label = false) const;  // convert to DOT string
 };
 
 inline iw_ungraph::iw_ungraph(int nverts)
-  : ungraph<int>(nverts)
+  : ungraph<iw_weight_t, flatEdges<> >(nverts)
 {
 }
 
-void delDeg12Nodes(ungraph<int> const& g, int src, int dst);
-
 #endif // iw_ungraph_hpp
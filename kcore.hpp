@@ -0,0 +1,200 @@
+#ifndef kcore_hpp
+#define kcore_hpp
+
+/*
+ k-core decomposition (degeneracy ordering).  The k-core is what is
+ left after repeatedly deleting vertices of degree < k;  core[v] is the
+ largest k whose k-core contains v.
+
+ coreNumbers() is Batagelj and Zaversnik's O(V + E) peel:  vertices
+ sit in an array sorted by current degree, with bin[d] the start of
+ degree d's run, so taking the minimum degree vertex and decreasing a
+ neighbor's degree (swap it to the front of its run, move the run
+ boundary) are both O(1), where repeated minOutDegreeIndex() calls cost
+ O(V) each.  order is the peel order (each vertex has at most
+ core[v] edges to vertices after it:  a degeneracy ordering).
+
+ parallelCoreNumbers() peels level by level instead (ParK style):  at
+ level k every remaining vertex of degree <= k is removed, the threads
+ decrementing their neighbors' degrees atomically;  whoever takes a
+ neighbor's degree from k+1 to k adds it to the next round of the same
+ level.  Levels with nothing to remove are skipped.  order lists the
+ vertices round by round (within a round the order depends on timing).
+
+ Degree is out-degree, and removing v lowers the degrees of v's
+ in-neighbors, which come from gin (as in hybridBfs():  an undirected
+ graph is its own gin, a digraph tracking its in-edges can use an
+ inEdgeView of itself).  Both return the degeneracy (the largest core
+ number, 0 for an empty graph).
+*/
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include "bfs.hpp"
+
+template <class G, class H>
+int coreNumbers(G const& g, H const& gin, std::vector<int>& core,
+		std::vector<int>& order)
+{
+  const int n = g.numVerts();
+  int maxdeg = 0;
+  core.resize(n);             // the current degree until v is peeled
+  for (int v = 0; v < n; v++) {
+    core[v] = g.adj(v).size();
+    maxdeg = std::max(maxdeg, core[v]);
+  }
+
+  // vert sorted by degree, pos[v] its index there, bin[d] where the
+  // vertices of degree d start
+  std::vector<int> bin(maxdeg + 2, 0), vert(n), pos(n);
+  for (int v = 0; v < n; v++) {
+    bin[core[v] + 1]++;
+  }
+  for (int d = 1; d <= maxdeg + 1; d++) {
+    bin[d] += bin[d-1];
+  }
+  for (int v = 0; v < n; v++) {
+    pos[v] = bin[core[v]]++;
+    vert[pos[v]] = v;
+  }
+  for (int d = maxdeg; d > 0; d--) {
+    bin[d] = bin[d-1];
+  }
+  bin[0] = 0;
+
+  int degeneracy = 0;
+  for (int i = 0; i < n; i++) {
+    const int v = vert[i];
+    degeneracy = std::max(degeneracy, core[v]);
+    scanNbrs(gin, v, [&](int u) {
+      if (core[u] > core[v]) {
+	// u to the front of its degree's run, which then starts after it
+	const int du = core[u];
+	const int w = vert[bin[du]];
+	if (w != u) {
+	  std::swap(vert[pos[u]], vert[bin[du]]);
+	  pos[w] = pos[u];
+	  pos[u] = bin[du];
+	}
+	bin[du]++;
+	core[u]--;
+      }
+      return false;
+    });
+  }
+  order.swap(vert);
+  return degeneracy;
+}
+
+// for undirected graphs, which are their own in-edge graph
+template <class G>
+inline int coreNumbers(G const& g, std::vector<int>& core,
+		       std::vector<int>& order)
+{
+  return coreNumbers(g, g, core, order);
+}
+
+template <class G, class H>
+int parallelCoreNumbers(G const& g, H const& gin, std::vector<int>& core,
+			std::vector<int>& order,
+			int nthreads = defaultThreads())
+{
+  nthreads = threadCount(nthreads);
+  const int n = g.numVerts();
+  const size_t CHUNK = 64;
+
+  std::vector<std::atomic<int> > deg(n);
+  for (int v = 0; v < n; v++) {
+    deg[v].store(g.adj(v).size(), std::memory_order_relaxed);
+  }
+  core.assign(n, -1);
+  order.resize(n);
+
+  std::vector<int> remaining(n), front;
+  for (int v = 0; v < n; v++) {
+    remaining[v] = v;
+  }
+  std::vector<std::vector<int> > bufs(nthreads);
+  std::vector<size_t> offset(nthreads + 1, 0);
+  std::atomic<size_t> pos(0);
+  spinBarrier barrier(nthreads);
+  int k = 0, done = 0;        // level, vertices peeled
+
+  parallelRun(nthreads, [&](int tid) {
+    std::vector<int>& out = bufs[tid];
+    while (done < n) {
+      // (tid 0) start a level:  drop peeled vertices from remaining,
+      // move up to the lowest degree left and gather its vertices
+      if (tid == 0) {
+	size_t j = 0;
+	int lowest = n;
+	for (size_t i = 0; i < remaining.size(); i++) {
+	  const int v = remaining[i];
+	  if (core[v] < 0) {
+	    remaining[j++] = v;
+	    lowest = std::min(lowest, deg[v].load(std::memory_order_relaxed));
+	  }
+	}
+	remaining.resize(j);
+	k = lowest;             // (> the last level:  it left none <= k)
+	front.clear();
+	for (size_t i = 0; i < remaining.size(); i++) {
+	  if (deg[remaining[i]].load(std::memory_order_relaxed) <= k)
+	    front.push_back(remaining[i]);
+	}
+	pos.store(0);
+      }
+      barrier.wait();
+
+      // rounds of this level, until no neighbor drops to k
+      for (;;) {
+	out.clear();
+	for (;;) {
+	  const size_t b = pos.fetch_add(CHUNK);
+	  if (b >= front.size())
+	    break;
+	  const size_t e = std::min(b + CHUNK, front.size());
+	  for (size_t i = b; i < e; i++) {
+	    const int v = front[i];
+	    core[v] = k;
+	    scanNbrs(gin, v, [&](int u) {
+	      if (deg[u].load(std::memory_order_relaxed) > k &&
+		  deg[u].fetch_sub(1) == k + 1)
+		out.push_back(u);
+	      return false;
+	    });
+	  }
+	}
+	barrier.wait();
+
+	if (tid == 0) {
+	  std::copy(front.begin(), front.end(), order.begin() + done);
+	  done += front.size();
+	  for (int t = 0; t < nthreads; t++) {
+	    offset[t+1] = offset[t] + bufs[t].size();
+	  }
+	  front.resize(offset[nthreads]);
+	  pos.store(0);
+	}
+	barrier.wait();
+	if (offset[nthreads] == 0)
+	  break;
+	std::copy(out.begin(), out.end(), front.begin() + offset[tid]);
+	barrier.wait();
+      }
+    }
+  });
+  return k;
+}
+
+template <class G>
+inline int parallelCoreNumbers(G const& g, std::vector<int>& core,
+			       std::vector<int>& order,
+			       int nthreads = defaultThreads())
+{
+  return parallelCoreNumbers(g, g, core, order, nthreads);
+}
+
+#endif // kcore_hpp
@@ -4,6 +4,7 @@
 
 #include "strfuncs.hpp"
 #include "iw_ungraph.hpp"
+#include "gridmap.hpp"
 
 using namespace std;
 
@@ -13,8 +14,8 @@ static bool run = false;
 static int swidth  = 720;
 static int sheight = swidth;
 
-// width x height number of cells
-static int width, height;
+// width x height number of cells (only the touched ones get storage)
+static cell_t width, height;
 static int depth = 0;  // keep track of recursion depth (not currently using)
 
 static int debug = 0;  // i.e. no debugging
@@ -22,7 +23,10 @@ static int debug = 0;  // i.e. no debugging
 static long gen = 0;   // generation number
 
 static iw_ungraph *g;
-vector<bool> gstate;
+static csrgraph<iw_ungraph::weight_t> gc;  // frozen g for the CA and drawing
+static vector<iw_ungraph::edge> gedges;  // edges gathered while building
+static gridmap grid;      // vertex id <-> (row, col) of its cell
+vector<bool> gstate;      // indexed by vertex id (NOT by cell)
 
 typedef struct {
   float r, g, b;
@@ -37,7 +41,9 @@ inline void init_color_index_shift()
   /*
     Consider the following ASCII Art 3x3 subgrid for the neighbors of
     node, N.  NOTE: width = 2^k + 1, where k is recursive level of
-    fractal.
+    fractal.  Neighbors are looked up by (row, col) offset from N, not
+    by cell number difference, so the table has 9 entries whatever the
+    width.
 
 
     |-------------|--------------|--------------|
@@ -57,8 +63,9 @@ inline void init_color_index_shift()
     |             |              |              |
     |-------------|--------------|--------------|
 
-    If the upper left cell (N-1-width) is given an index of 0, then
-    the neighbor cells are assigned shift values (in a clockwise order
+    If the upper left cell (N-1-width) is given an index of 0 (and the
+    cells are numbered row by row, so N+1+width is 8), then the
+    neighbor cells are assigned shift values (in a clockwise order
     starting from the right neighbor).  The shift values are indicated
     in parentheses.  These shift values are used to "SHIFT and OR"
     each one bit into an 8-bit color index byte (see get_mycolor_index
@@ -67,13 +74,13 @@ inline void init_color_index_shift()
     neighbors are true neighbors.
    */
 
-  color_index_shift.resize(2*(width+1)+1, 0);
+  color_index_shift.resize(9, 0);
 
-  color_index_shift[width+2] = 7;     // immed. right cell, go clockwise...
-  color_index_shift[2*(width+1)] = 6;
-  color_index_shift[2*width+1] = 5;
-  color_index_shift[2*width] = 4;
-  color_index_shift[width] = 3;
+  color_index_shift[5] = 7;     // immed. right cell, go clockwise...
+  color_index_shift[8] = 6;
+  color_index_shift[7] = 5;
+  color_index_shift[6] = 4;
+  color_index_shift[3] = 3;
   color_index_shift[0] = 2;
   color_index_shift[1] = 1;
   color_index_shift[2] = 0;
@@ -85,10 +92,12 @@ int get_mycolor_index(int k)
   if (debug)
     cout << "si = ";
   /*
-    For each neighbor, it->first, of node k, compute the difference in
-    node number values.  Add width+1 to this difference to yield a
-    positive range, to be used as an index into the color_index_shift
-    vector.  At most there can be eight neighbors.
+    For each neighbor, *w, of node k, compute the row and column
+    differences of their grid cells (vertex ids are dense, so map them
+    back to their cells first).  Each is -1, 0 or 1;  shifted to 0..2
+    they give a row-major position in the 3x3 subgrid, to be used as
+    an index into the color_index_shift vector.  At most there can be
+    eight neighbors.
 
     For the simple fractally-inspired sierpinski graph I initially
     created (circa Aug. 2013), there is a maximum of 4 neighbors, with
@@ -99,10 +108,11 @@ int get_mycolor_index(int k)
     pieces instead of 256 for this sierpinski instance, but I didn't.
    */
 
-  for (iw_ungraph::umapEdge::const_iterator it = g->adj(k).begin();
-       it != g->adj(k).end(); ++it) {
-    int diff = it->first - k;    // diff range       :  [-(width+1), width+1]
-    int si = diff + width + 1;   // shift index range:  [0, 2*(width+1)]
+  for (int const* w = gc.nbrBegin(k); w != gc.nbrEnd(k); ++w) {
+    // row and column differences range:  [-1, 1]
+    int drow = (long long) grid.row(*w) - (long long) grid.row(k);
+    int dcol = (long long) grid.col(*w) - (long long) grid.col(k);
+    int si = 3*(drow + 1) + dcol + 1;   // shift index range:  [0, 8]
 
     if (debug)
       cout << si << " ";
@@ -118,11 +128,9 @@ void init_mycolors()
 {
   vector<bool> colors(256, false);
 
-  for (int k = 0; k < g->numVerts(); k++) {      // for each cell
-    if (g->adj(k).size() > 0) {                  // if cell has neighbors
-      int ci = get_mycolor_index(k);
-      colors[ci] = true;
-    }
+  for (int k = 0; k < gc.numVerts(); k++) {      // for each (active) cell
+    int ci = get_mycolor_index(k);
+    colors[ci] = true;
   }
 
   int count = 0;
@@ -153,9 +161,9 @@ inline void set_mycolor(int k)
   glColor3f(mycolors[ci].r, mycolors[ci].g, mycolors[ci].b);
 }
 
-inline int mypow2(int k)
+inline cell_t mypow2(int k)
 {
-  int res = 1;
+  cell_t res = 1;
   for (int i = 0; i < k; i++) {
     res *= 2;
   }
@@ -163,43 +171,49 @@ inline int mypow2(int k)
   return res;
 }
 
-inline int midpoint(int a, int b)
+inline cell_t midpoint(cell_t a, cell_t b)
 {
   // NOTE: a/width is the row of a;  a%width is the col of a
   return (a/width+b/width)/2*width+(a%width+b%width)/2;
 }
 
-inline void tri_connect(int a, int b, int c)
+// edges are only collected here; main() adds them all at once with
+// g->addEdges() when the recursion is done.  a cell becomes a vertex
+// (gets an id) the first time an edge touches it
+inline void tri_connect(cell_t a, cell_t b, cell_t c)
 {
-  g->addEdge(a, b, depth);
-  g->addEdge(b, c, depth);
-  g->addEdge(c, a, depth);
+  int ia = grid.insert(a);
+  int ib = grid.insert(b);
+  int ic = grid.insert(c);
+  gedges.push_back(iw_ungraph::edge(ia, ib, depth));
+  gedges.push_back(iw_ungraph::edge(ib, ic, depth));
+  gedges.push_back(iw_ungraph::edge(ic, ia, depth));
 }
 //Modifications to be made:
 //Mod4
-void build_sierpinski_graph(int a, int b, int c)
+void build_sierpinski_graph(cell_t a, cell_t b, cell_t c)
 {
   depth++;
 
   if (debug)
     cerr << "a = " << a << " b = " << b << " c = " << c << "\n";
 
-  int ab = midpoint(a, b);
-  int bc = midpoint(b, c);
-  int ac = midpoint(a, c);
+  cell_t ab = midpoint(a, b);
+  cell_t bc = midpoint(b, c);
+  cell_t ac = midpoint(a, c);
 
   //new ints for the other midpoints on the outer edge
-  int ab1 = midpoint(a, ab);
-  int ab2 = midpoint(b, ab);
-  int bc1 = midpoint(b, bc);
-  int bc2 = midpoint(c, bc);
-  int ac1 = midpoint(a, ac);
-  int ac2 = midpoint(c, ac);
+  cell_t ab1 = midpoint(a, ab);
+  cell_t ab2 = midpoint(b, ab);
+  cell_t bc1 = midpoint(b, bc);
+  cell_t bc2 = midpoint(c, bc);
+  cell_t ac1 = midpoint(a, ac);
+  cell_t ac2 = midpoint(c, ac);
 
   //new ints for the midpoints inside the triangle 
-  int top = midpoint(ab, ac);
-  int left = midpoint(ab, bc);
-  int right = midpoint(ab, ac);
+  cell_t top = midpoint(ab, ac);
+  cell_t left = midpoint(ab, bc);
+  cell_t right = midpoint(ab, ac);
 
   if (ab > a && ac > ab) {
     if (debug)
@@ -260,11 +274,11 @@ bool next_state_rule(int k)
 {
   // Here is a "first crack" at a rule for each cell, k, of our fractal CA
 
-  // first count the number of live neighbors to node k
+  // first count the number of live neighbors to node k (topology only,
+  // so read just the neighbor array of the CSR form)
   int live_neighs = 0;
-  for (iw_ungraph::umapEdge::const_iterator it = g->adj(k).begin();
-       it != g->adj(k).end(); ++it) {
-    live_neighs += gstate[it->first];
+  for (int const* w = gc.nbrBegin(k); w != gc.nbrEnd(k); ++w) {
+    live_neighs += gstate[*w];
   }
 
   if (debug)
@@ -287,12 +301,11 @@ void apply_rule_to_all_cells()
   if (++gen % 100 == 0)
     cout << "\tgeneration = " << gen << "\n";
 
-  vector<bool> new_gstate(width*height, false);  // new vector of next states
+  vector<bool> new_gstate(gc.numVerts(), false); // new vector of next states
 
-  for (int k = 0; k < g->numVerts(); k++) {      // for each cell
-    if (g->adj(k).size() > 0) {                  // if cell has neighbors
-      new_gstate[k] = next_state_rule(k);        // compute next cel state
-    }
+  // after compaction every vertex is a cell with neighbors
+  for (int k = 0; k < gc.numVerts(); k++) {      // for each cell
+    new_gstate[k] = next_state_rule(k);          // compute next cel state
   } // end for each vertex loop
 
   gstate = new_gstate;  // copy in "one fell swoop" into gstate vector
@@ -330,11 +343,11 @@ void drawgrid()
   glColor3f(0.3, 0.3, 0.3);      // draw in light grey
   glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);  // outline polys, not filled
 
-  for (int i = 0; i < height; i++) {
+  for (cell_t i = 0; i < height; i++) {
     double y = i*cellheight;
 
     glBegin(GL_QUAD_STRIP);
-    for (int j = 0; j <= width; j++) {
+    for (cell_t j = 0; j <= width; j++) {
       double x = j*cellwidth;
 
       glVertex2f(x, y);
@@ -351,27 +364,25 @@ void drawgraph()
 
   glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);  // filled polygon
 
-  for (int k = 0; k < g->numVerts(); k++) {
-    if (g->adj(k).size() > 0) {
-      glBegin(GL_POLYGON);
-         int i = k / height;
-	 int j = k % height;
-
-	 double x = j*cellwidth;
-	 double y = i*cellheight;
-
-	 if (gstate[k]) {
-	   set_mycolor(k);   // draw live cells color for neighborhood
-	 }
-	 else
-	   glColor3f(1.0, 0.0, 0.0);  // draw dead cells in red
-
-         glVertex2f(x, y);
-         glVertex2f(x+cellwidth, y);
-	 glVertex2f(x+cellwidth, y+cellheight);
-	 glVertex2f(x, y+cellheight);
-      glEnd();
-    }
+  for (int k = 0; k < gc.numVerts(); k++) {     // every vertex is a cell
+    glBegin(GL_POLYGON);
+       cell_t i = grid.row(k);
+       cell_t j = grid.col(k);
+
+       double x = j*cellwidth;
+       double y = i*cellheight;
+
+       if (gstate[k]) {
+	 set_mycolor(k);   // draw live cells color for neighborhood
+       }
+       else
+	 glColor3f(1.0, 0.0, 0.0);  // draw dead cells in red
+
+       glVertex2f(x, y);
+       glVertex2f(x+cellwidth, y);
+       glVertex2f(x+cellwidth, y+cellheight);
+       glVertex2f(x, y+cellheight);
+    glEnd();
   }
 }
 
@@ -417,11 +428,14 @@ void mouse(int button, int state, int x, int y)
     break;
   case GLUT_RIGHT_BUTTON:
     if (state == GLUT_DOWN) {
-      int row = y / cellwidth;
-      int col = x / cellheight;
-      int k = row*width+col;
+      cell_t row = y / cellwidth;
+      cell_t col = x / cellheight;
+      int k = grid.id(row, col);
 
-      cerr << "toggling state of node number " << k << "\n";
+      if (k < 0)
+	break;   // not a cell of the graph
+
+      cerr << "toggling state of node number " << row*width+col << "\n";
 
       // toggle the state (live/dead)
       gstate[k] = !gstate[k];
@@ -458,8 +472,9 @@ int main(int argc, char** argv)
   }
 
   int k = str2num<int>(argv[1]);
-  if (k < 1 || k > 10) {
-    cerr << "k must be an integer in range [1, 10]\n";
+  // 64 bit cell numbers:  width*height = (2^(4k)+1)^2 must fit
+  if (k < 1 || k > 7) {
+    cerr << "k must be an integer in range [1, 7]\n";
     return 2;
   }
 
@@ -470,28 +485,38 @@ int main(int argc, char** argv)
     debug = str2num<int>(argv[2]);
   }
 
-  g = new iw_ungraph(width*height);
-
-  gstate.resize(width*height, false);
-
   init_color_index_shift();
 
   // top middle, bottom left, bottom right vertices of a triangle
-  int a = (width-1) / 2;
-  int b = (height-1)*width;
-  int c = height*width - 1;
+  cell_t a = (width-1) / 2;
+  cell_t b = (height-1)*width;
+  cell_t c = height*width - 1;
 
+  // the cells that get edges are numbered 0, 1, ... as they're touched
+  grid = gridmap(width, height);
   build_sierpinski_graph(a, b, c);
 
+  g = new iw_ungraph(grid.numIds());
+  g->addEdges(gedges.begin(), gedges.end(), true);
+  vector<iw_ungraph::edge>().swap(gedges);   // free the edge list
+  gstate.resize(g->numVerts(), false);
+
+  // number the cells along a Hilbert curve, so the neighbors of a cell
+  // (a whole row away in row-major order) get nearby ids
+  vector<int> perm = grid.hilbertOrder();
+  g->relabel(perm, g->numVerts());
+  grid.permute(perm);
+
+  gc = g->freeze();   // graph no longer changes, so traverse the CSR form
+
   string gstr = g->toDOT();
 
   cout << gstr;
 
   if (debug) {
     for (int i = 0; i < g->numVerts(); i++) {
-      if (g->adj(i).size() > 0) {
-	cerr << "vertex " << i << " degree is " << g->adj(i).size() << "\n";
-      }
+      cerr << "vertex " << grid.cell(i) << " degree is " << g->adj(i).size()
+	   << "\n";
     }
   }
 
@@ -0,0 +1,317 @@
+// push-relabel maximum flow and DIMACS input (see maxflow.hpp)
+
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+
+#include "strfuncs.hpp"
+#include "maxflow.hpp"
+
+using std::string;
+using std::vector;
+using std::pair;
+
+// global relabel once the relabel work exceeds (ALPHA*n + m)/FREQ;  a
+// relabel costs BETA plus the arcs it scans
+static const int ALPHA = 6;
+static const int BETA = 12;
+static const double FREQ = 0.5;
+
+void maxflow::build(vector<int> const& from, vector<int> const& to,
+		    vector<long long> const& cap)
+{
+  // each edge is an arc and a reverse arc (residual capacity only)
+  m_off.assign(m_n + 1, 0);
+  for (size_t i = 0; i < from.size(); i++) {
+    if (from[i] != to[i]) {
+      m_off[from[i] + 1]++;
+      m_off[to[i] + 1]++;
+    }
+  }
+  for (int v = 0; v < m_n; v++) {
+    m_off[v+1] += m_off[v];
+  }
+  const int narcs = m_off[m_n];
+  m_head.resize(narcs);
+  m_rev.resize(narcs);
+  m_cap.assign(narcs, 0);
+
+  vector<int> pos(m_off.begin(), m_off.end() - 1);
+  for (size_t i = 0; i < from.size(); i++) {
+    if (from[i] == to[i])
+      continue;               // self loops carry no flow
+    const int a = pos[from[i]]++;
+    const int b = pos[to[i]]++;
+    m_head[a] = to[i];
+    m_head[b] = from[i];
+    m_rev[a] = b;
+    m_rev[b] = a;
+    m_cap[a] = std::max(0LL, cap[i]);
+  }
+
+  m_excess.resize(m_n);
+  m_height.resize(m_n);
+  m_cur.resize(m_n);
+  m_first.resize(m_n);
+  m_next.resize(m_n);
+  m_prev.resize(m_n);
+  m_active.resize(m_n);
+}
+
+long long maxflow::solve(int src, int dst)
+{
+  m_src = src;
+  m_dst = dst;
+  m_res = m_cap;
+  std::fill(m_excess.begin(), m_excess.end(), 0);
+  m_value = 0;
+  m_side.assign(m_n, false);
+  if (src == dst) {
+    m_side[src] = true;
+    return 0;
+  }
+
+  // saturate the source's arcs;  it then stays at height n
+  for (int a = m_off[src]; a < m_off[src+1]; a++) {
+    const long long r = m_res[a];
+    m_res[a] = 0;
+    m_res[m_rev[a]] += r;
+    m_excess[m_head[a]] += r;
+    m_excess[src] -= r;
+  }
+  globalRelabel();
+
+  const long long limit = (ALPHA * (long long) m_n + m_off[m_n]) / FREQ;
+  while (m_maxActive >= 0) {
+    vector<int>& bucket = m_active[m_maxActive];
+    if (bucket.empty()) {
+      m_maxActive--;
+      continue;
+    }
+    const int v = bucket.back();
+    bucket.pop_back();
+    if (m_height[v] != m_maxActive || m_excess[v] == 0)
+      continue;
+    discharge(v);
+    if (m_work > limit)
+      globalRelabel();
+  }
+  m_value = m_excess[dst];
+
+  // the source side:  vertices that can't reach dst in the residual
+  // graph (what globalRelabel() computes, but for every vertex)
+  vector<bool> reach(m_n, false);
+  vector<int> queue(1, dst);
+  reach[dst] = true;
+  for (size_t i = 0; i < queue.size(); i++) {
+    const int x = queue[i];
+    for (int a = m_off[x]; a < m_off[x+1]; a++) {
+      const int y = m_head[a];
+      if (!reach[y] && m_res[m_rev[a]] > 0) {
+	reach[y] = true;
+	queue.push_back(y);
+      }
+    }
+  }
+  for (int v = 0; v < m_n; v++) {
+    m_side[v] = !reach[v];
+  }
+  return m_value;
+}
+
+vector<pair<int, int> > maxflow::cutEdges() const
+{
+  vector<pair<int, int> > cut;
+  if (m_side.empty())
+    return cut;
+  for (int v = 0; v < m_n; v++) {
+    if (!m_side[v])
+      continue;
+    for (int a = m_off[v]; a < m_off[v+1]; a++) {
+      if (m_cap[a] > 0 && !m_side[m_head[a]])
+	cut.push_back(pair<int, int>(v, m_head[a]));
+    }
+  }
+  return cut;
+}
+
+// exact distances to dst (n where there is no residual path) by a
+// reverse BFS;  rebuilds the height lists and the active buckets
+void maxflow::globalRelabel()
+{
+  m_work = 0;
+  std::fill(m_height.begin(), m_height.end(), m_n);
+  std::fill(m_first.begin(), m_first.end(), -1);
+  for (int h = 0; h < m_n; h++) {
+    m_active[h].clear();
+  }
+  m_maxActive = -1;
+  m_maxHeight = 0;
+
+  vector<int> queue(1, m_dst);
+  m_height[m_dst] = 0;
+  for (size_t i = 0; i < queue.size(); i++) {
+    const int x = queue[i];
+    for (int a = m_off[x]; a < m_off[x+1]; a++) {
+      const int y = m_head[a];
+      if (m_height[y] == m_n && y != m_src && m_res[m_rev[a]] > 0) {
+	m_height[y] = m_height[x] + 1;
+	queue.push_back(y);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < queue.size(); i++) {
+    const int v = queue[i];
+    const int h = m_height[v];
+    setHeight(v, h);
+    m_cur[v] = m_off[v];
+    if (m_excess[v] > 0 && v != m_dst) {
+      m_active[h].push_back(v);
+      m_maxActive = std::max(m_maxActive, h);
+    }
+  }
+}
+
+// push v's excess downhill, relabeling v whenever it runs out of
+// admissible arcs, until the excess is gone or v is cut off from dst
+void maxflow::discharge(int v)
+{
+  int h = m_height[v];
+  for (;;) {
+    for (int& a = m_cur[v]; a < m_off[v+1]; a++) {
+      const int w = m_head[a];
+      if (m_res[a] == 0 || m_height[w] != h - 1)
+	continue;
+      const long long d = std::min(m_excess[v], m_res[a]);
+      m_res[a] -= d;
+      m_res[m_rev[a]] += d;
+      if (m_excess[w] == 0 && w != m_dst) {
+	m_active[h-1].push_back(w);
+	m_maxActive = std::max(m_maxActive, h - 1);
+      }
+      m_excess[w] += d;
+      m_excess[v] -= d;
+      if (m_excess[v] == 0)
+	return;               // (the current arc may have more room)
+    }
+
+    // relabel:  one above the lowest residual neighbor
+    int nh = m_n, ca = m_off[v];
+    for (int a = m_off[v]; a < m_off[v+1]; a++) {
+      if (m_res[a] > 0 && m_height[m_head[a]] + 1 < nh) {
+	nh = m_height[m_head[a]] + 1;
+	ca = a;
+      }
+    }
+    m_work += BETA + m_off[v+1] - m_off[v];
+    unlink(v);
+    if (m_first[h] < 0) {
+      gap(h);                 // v was the last one at h
+      m_height[v] = m_n;
+      return;
+    }
+    if (nh >= m_n) {
+      m_height[v] = m_n;
+      return;
+    }
+    setHeight(v, nh);
+    m_cur[v] = ca;
+    h = nh;
+  }
+}
+
+void maxflow::setHeight(int v, int h)
+{
+  m_height[v] = h;
+  m_prev[v] = -1;
+  m_next[v] = m_first[h];
+  if (m_first[h] >= 0)
+    m_prev[m_first[h]] = v;
+  m_first[h] = v;
+  m_maxHeight = std::max(m_maxHeight, h);
+}
+
+void maxflow::unlink(int v)
+{
+  if (m_prev[v] >= 0)
+    m_next[m_prev[v]] = m_next[v];
+  else
+    m_first[m_height[v]] = m_next[v];
+  if (m_next[v] >= 0)
+    m_prev[m_next[v]] = m_prev[v];
+}
+
+// nothing is left at height h:  everything above it can't reach dst
+void maxflow::gap(int h)
+{
+  for (int g = h + 1; g <= m_maxHeight; g++) {
+    for (int v = m_first[g]; v >= 0; v = m_next[v]) {
+      m_height[v] = m_n;
+    }
+    m_first[g] = -1;
+    m_active[g].clear();
+  }
+  m_maxHeight = h - 1;
+}
+
+digraph<int> readDIMACS(std::istream& in, int& src, int& dst)
+{
+  digraph<int> g(0);
+  int nverts = -1;
+  src = dst = -1;
+
+  string line;
+  for (int lineno = 1; std::getline(in, line); lineno++) {
+    std::istringstream ls(line);
+    string what;
+    if (!(ls >> what) || what == "c")
+      continue;               // blank or comment
+    const string where = "readDIMACS() line " + num2str<int>(lineno);
+
+    if (what == "p") {
+      string kind;
+      int nedges;
+      if (nverts >= 0 || !(ls >> kind >> nverts >> nedges) || kind != "max"
+	  || nverts < 0)
+	throw std::runtime_error(where + ": bad problem line");
+      g.resize(nverts);
+      continue;
+    }
+    if (nverts < 0)
+      throw std::runtime_error(where + ": no problem line yet");
+
+    if (what == "n") {
+      int id;
+      string st;
+      if (!(ls >> id >> st) || id < 1 || id > nverts
+	  || (st != "s" && st != "t"))
+	throw std::runtime_error(where + ": bad node line");
+      (st == "s" ? src : dst) = id - 1;
+    }
+    else if (what == "a") {
+      int u, v;
+      long long cap;
+      if (!(ls >> u >> v >> cap) || u < 1 || u > nverts || v < 1
+	  || v > nverts || cap < 0)
+	throw std::runtime_error(where + ": bad arc line");
+      // (a repeated arc adds to the capacity so far, which must still
+      // fit the int edge information)
+      digraph<int>::const_iterator it = g.findEdge(u-1, v-1);
+      if (it != g.adj(u-1).end())
+	cap += it->second;
+      if (cap > std::numeric_limits<int>::max())
+	throw std::runtime_error(where + ": capacity out of range");
+      std::pair<digraph<int>::iterator, bool> r = g.addEdge(u-1, v-1, cap);
+      if (!r.second)
+	r.first->second = cap;
+    }
+    else
+      throw std::runtime_error(where + ": unknown line type " + what);
+  }
+  if (nverts < 0 || src < 0 || dst < 0)
+    throw std::runtime_error("readDIMACS(): missing problem, s or t line");
+  return g;
+}
@@ -0,0 +1,97 @@
+#ifndef maxflow_hpp
+#define maxflow_hpp
+
+/*
+ Maximum flow / minimum cut by push-relabel (Goldberg and Tarjan), in
+ the highest label variant with the two heuristics that make it fast
+ in practice (Cherkassky and Goldberg):
+
+   global relabeling - every so often the labels are reset to exact
+                       residual distances to the sink by a reverse BFS
+   gap               - when no vertex is left at some height h, every
+                       vertex above h is cut off from the sink and
+                       lifted out of play at once
+
+ Only the first phase is run (a maximum preflow), which is all the flow
+ value and a minimum cut need.  Capacities are the edge information of
+ a digraph (nonnegative, anything that converts to long long), so the
+ problems toDIMACS() writes out can be solved in process:
+
+   maxflow mf(g);
+   long long f = mf.solve(src, dst);
+   std::vector<std::pair<int, int> > cut = mf.cutEdges();
+
+ readDIMACS() reads such a problem back ("p max", "n ... s/t", "a"
+ lines;  arcs repeated in the file have their capacities summed).
+*/
+
+#include <iosfwd>
+#include <vector>
+#include <utility>
+
+#include "digraph.hpp"
+
+class maxflow {
+public:
+  template <class T, class S, class A>
+  explicit maxflow(digraph<T, S, A> const& g);
+
+  long long solve(int src, int dst);   // returns the maximum flow value
+
+  // after solve():  the value again, the source side of a minimum cut
+  // (sourceSide()[v] is true if v is on it) and the edges it cuts
+  long long flowValue() const { return m_value; }
+  std::vector<bool> const& sourceSide() const { return m_side; }
+  std::vector<std::pair<int, int> > cutEdges() const;
+private:
+  void build(std::vector<int> const& from, std::vector<int> const& to,
+	     std::vector<long long> const& cap);
+  void globalRelabel();
+  void discharge(int v);
+  void setHeight(int v, int h);        // (v must be in no height list)
+  void unlink(int v);
+  void gap(int h);
+
+  int m_n, m_src, m_dst;
+  std::vector<int> m_off;              // arcs of v:  m_off[v] .. m_off[v+1]-1
+  std::vector<int> m_head, m_rev;      // arc target, its reverse arc
+  std::vector<long long> m_cap;        // input capacity (0 for reverse arcs)
+  std::vector<long long> m_res;        // residual capacity
+
+  std::vector<long long> m_excess;
+  std::vector<int> m_height, m_cur;    // label, current arc
+  std::vector<int> m_first, m_next, m_prev;   // vertices by height
+  std::vector<std::vector<int> > m_active;    // active vertices by height
+  int  m_maxActive, m_maxHeight;
+  long long m_work;                    // since the last global relabel
+
+  long long m_value;
+  std::vector<bool> m_side;
+};
+
+template <class T, class S, class A>
+maxflow::maxflow(digraph<T, S, A> const& g)
+  : m_n(g.numVerts()), m_src(-1), m_dst(-1), m_value(0)
+{
+  std::vector<int> from, to;
+  std::vector<long long> cap;
+  from.reserve(g.numEdges());
+  to.reserve(g.numEdges());
+  cap.reserve(g.numEdges());
+  for (int v = 0; v < g.numVerts(); v++) {
+    for (typename digraph<T, S, A>::const_iterator it = g.adj(v).begin();
+	 it != g.adj(v).end(); ++it) {
+      from.push_back(v);
+      to.push_back(it->first);
+      cap.push_back(it->second);
+    }
+  }
+  build(from, to, cap);
+}
+
+// read a DIMACS max flow problem;  throws std::runtime_error (with the
+// line number) on malformed input, or on a capacity (summed over
+// repeats of an arc) that doesn't fit an int
+digraph<int> readDIMACS(std::istream& in, int& src, int& dst);
+
+#endif // maxflow_hpp
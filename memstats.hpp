@@ -0,0 +1,99 @@
+#ifndef memstats_hpp
+#define memstats_hpp
+
+/*
+ Memory and hash health summary of a graph (see digraph::memoryStats).
+ Bytes are split into
+
+   topology - one neighbor id (int) per edge
+   payload  - one edge information object (T) per edge, or nothing
+              where the storage keeps no T (flatEdges with an empty T)
+   overhead - everything else:  per vertex container objects, empty
+              buckets/slots, hash nodes' links, padding in entries, ...
+   index    - the in-edge index, if the graph keeps one
+
+ Heap bytes of std::unordered_map storage are estimated from its node
+ and bucket layout (allocator bookkeeping is not counted), so treat the
+ totals as a close lower bound rather than an exact figure.
+
+ The histograms are over vertices.  degree and buckets use power of 2
+ bins:  bin 0 counts the zeros and bin k >= 1 the values in
+ [2^(k-1), 2^k).  load has ten bins of width 0.1, the last one also
+ catching everything >= 1.
+*/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "strfuncs.hpp"
+
+struct memStats {
+  memStats() : nverts(0), nedges(0), topology(0), payload(0),
+	       overhead(0), index(0), load(10, 0) {}
+
+  int    nverts;
+  int    nedges;
+  size_t topology;
+  size_t payload;
+  size_t overhead;
+  size_t index;
+  size_t total() const { return topology + payload + overhead + index; }
+
+  std::vector<int> degree;     // out degree histogram (power of 2 bins)
+  std::vector<int> buckets;    // bucket_count() histogram (power of 2 bins)
+  std::vector<int> load;       // load_factor() histogram (0.1 wide bins)
+
+  static void count(std::vector<int>& hist, size_t value);   // pow 2 bins
+  static void countLoad(std::vector<int>& hist, float lf);   // 0.1 bins
+
+  std::string toString() const;
+};
+
+inline void memStats::count(std::vector<int>& hist, size_t value)
+{
+  size_t bin = 0;
+  while (value) {
+    value >>= 1;
+    bin++;
+  }
+  if (bin >= hist.size())
+    hist.resize(bin + 1, 0);
+  hist[bin]++;
+}
+
+inline void memStats::countLoad(std::vector<int>& hist, float lf)
+{
+  int bin = (int) (lf * 10);
+  hist[bin < 0 ? 0 : (bin > 9 ? 9 : bin)]++;
+}
+
+inline std::string memStats::toString() const
+{
+  std::string res = "vertices " + num2str(nverts)
+    + ", edges " + num2str(nedges) + "\n";
+  res += "bytes:  topology " + num2str(topology)
+    + ", payload " + num2str(payload)
+    + ", overhead " + num2str(overhead)
+    + ", index " + num2str(index)
+    + ", total " + num2str(total()) + "\n";
+
+  res += "degree:";
+  for (size_t k = 0; k < degree.size(); k++) {
+    res += " " + num2str(k ? (size_t) 1 << (k - 1) : 0)
+      + ":" + num2str(degree[k]);
+  }
+  res += "\nbuckets:";
+  for (size_t k = 0; k < buckets.size(); k++) {
+    res += " " + num2str(k ? (size_t) 1 << (k - 1) : 0)
+      + ":" + num2str(buckets[k]);
+  }
+  res += "\nload:";
+  for (size_t i = 0; i < load.size(); i++) {
+    res += " ." + num2str(i) + ":" + num2str(load[i]);
+  }
+  res += "\n";
+  return res;
+}
+
+#endif // memstats_hpp
@@ -0,0 +1,171 @@
+#ifndef msbfs_hpp
+#define msbfs_hpp
+
+/*
+ Multi-source BFS (Then et al., "The More the Merrier"):  one sweep
+ over the graph runs the breadth-first searches of up to 64*W sources
+ at once.  Each vertex carries W words of source bits:  seen (sources
+ that have reached it) and visit (sources whose frontier it is in), so
+ one pass over an edge v -> w advances every search that has v in its
+ frontier:
+
+   newly = visit[v] & ~seen[w];  seen[w] |= newly;  next[w] |= newly
+
+ Sources are taken 64 per sweep when there are at most 64 of them and
+ 256 (W = 4) otherwise;  the W word loops are what the compiler turns
+ into SIMD code on targets that have it (e.g. -mavx2).
+
+ multiBfs() returns the distances from every source (dist[i][v] for
+ source srcs[i], -1 if unreached), multiBfsHistogram() only aggregates:
+ hist[d] counts the (source, vertex) pairs at distance d and ecc[i] is
+ the eccentricity of srcs[i] within its component;  that needs no
+ per vertex work beyond the sweep itself.  Works over any graph
+ hybridBfs() does (see bfs.hpp);  searches follow out-edges.
+*/
+
+#include <vector>
+#include <algorithm>
+
+#include "bfs.hpp"
+
+// one sweep for the nsrc <= 64*W sources at src;  calls
+// reach(w, level, bits) for every vertex w newly reached (at level) by
+// the sources whose bits are set in bits[0 .. W-1]
+template <int W, class G, class F>
+void msBfsSweep(G const& g, int const* src, int nsrc, F reach)
+{
+  typedef bitmap::word_t word_t;
+  const int n = g.numVerts();
+
+  std::vector<word_t> seen(n * W, 0), visit(n * W, 0), next(n * W, 0);
+  std::vector<int> front, nfront;     // vertices with visit (next) bits
+
+  for (int i = 0; i < nsrc; i++) {
+    const int v = src[i];
+    word_t bit[W] = {};
+    bit[i / 64] = (word_t) 1 << (i % 64);
+    if (std::count(&visit[v*W], &visit[v*W] + W, (word_t) 0) == W)
+      front.push_back(v);         // (not already in as another source)
+    for (int k = 0; k < W; k++) {
+      seen[v*W + k] |= bit[k];
+      visit[v*W + k] |= bit[k];
+    }
+    reach(v, 0, bit);
+  }
+
+  for (int level = 1; !front.empty(); level++) {
+    nfront.clear();
+    for (size_t i = 0; i < front.size(); i++) {
+      const int v = front[i];
+      word_t const* vis = &visit[v*W];
+      scanNbrs(g, v, [&](int w) {
+	word_t newly[W];
+	word_t any = 0;
+	for (int k = 0; k < W; k++) {
+	  newly[k] = vis[k] & ~seen[w*W + k];
+	  any |= newly[k];
+	}
+	if (!any)
+	  return false;
+	word_t was = 0;
+	for (int k = 0; k < W; k++) {
+	  was |= next[w*W + k];
+	  seen[w*W + k] |= newly[k];
+	  next[w*W + k] |= newly[k];
+	}
+	if (!was)
+	  nfront.push_back(w);
+	reach(w, level, newly);
+	return false;
+      });
+    }
+
+    // next becomes visit (only the frontier vertices have bits to clear)
+    for (size_t i = 0; i < front.size(); i++) {
+      std::fill(&visit[front[i]*W], &visit[front[i]*W] + W, 0);
+    }
+    for (size_t i = 0; i < nfront.size(); i++) {
+      const int w = nfront[i];
+      std::copy(&next[w*W], &next[w*W] + W, &visit[w*W]);
+      std::fill(&next[w*W], &next[w*W] + W, 0);
+    }
+    front.swap(nfront);
+  }
+}
+
+// runs msBfsSweep() over srcs in batches (64 or 256 at a time);  reach
+// gets the index of the batch's first source as well
+template <class G, class F>
+void msBfsBatches(G const& g, std::vector<int> const& srcs, F reach)
+{
+  const int nsrc = srcs.size();
+  if (nsrc <= 64) {
+    if (nsrc > 0)
+      msBfsSweep<1>(g, srcs.data(), nsrc,
+		    [&](int w, int level, bitmap::word_t const* bits) {
+		      reach(0, w, level, bits, 1);
+		    });
+    return;
+  }
+  for (int b = 0; b < nsrc; b += 256) {
+    msBfsSweep<4>(g, srcs.data() + b, std::min(256, nsrc - b),
+		  [&](int w, int level, bitmap::word_t const* bits) {
+		    reach(b, w, level, bits, 4);
+		  });
+  }
+}
+
+template <class G>
+void multiBfs(G const& g, std::vector<int> const& srcs,
+	      std::vector<std::vector<int> >& dist)
+{
+  dist.assign(srcs.size(), std::vector<int>(g.numVerts(), -1));
+  msBfsBatches(g, srcs, [&](int base, int w, int level,
+			    bitmap::word_t const* bits, int nwords) {
+    for (int k = 0; k < nwords; k++) {
+      for (bitmap::word_t b = bits[k]; b; b &= b - 1) {
+	dist[base + k*64 + __builtin_ctzll(b)][w] = level;
+      }
+    }
+  });
+}
+
+template <class G>
+void multiBfsHistogram(G const& g, std::vector<int> const& srcs,
+		       std::vector<long long>& hist, std::vector<int>& ecc)
+{
+  hist.clear();
+  ecc.assign(srcs.size(), 0);
+
+  // sources reaching anything at the current (base, level):  levels
+  // only grow within a batch, so the last level a source shows up in
+  // is its eccentricity.  flushed whenever (base, level) changes
+  int cbase = 0, clevel = 0;
+  bitmap::word_t active[4] = {};
+  auto flush = [&]() {
+    for (int k = 0; k < 4; k++) {
+      for (bitmap::word_t b = active[k]; b; b &= b - 1) {
+	ecc[cbase + k*64 + __builtin_ctzll(b)] = clevel;
+      }
+      active[k] = 0;
+    }
+  };
+
+  msBfsBatches(g, srcs, [&](int base, int, int level,
+			    bitmap::word_t const* bits, int nwords) {
+    if (base != cbase || level != clevel) {
+      flush();
+      cbase = base;
+      clevel = level;
+    }
+    if ((int) hist.size() <= level)
+      hist.resize(level + 1, 0);
+    for (int k = 0; k < nwords; k++) {
+      hist[level] += __builtin_popcountll(bits[k]);
+      active[k] |= bits[k];
+    }
+  });
+  flush();
+}
+
+#endif // msbfs_hpp
@@ -0,0 +1,269 @@
+#ifndef myhash_hpp
+#define myhash_hpp
+
+/*
+ An open addressing (Robin Hood) hash map from int to T used as
+ edgeContainer storage (see myHashEdges in digraph.hpp and the
+ USE_MY_HASH switch).  Entries live inline in one power of 2 slot array
+ together with their distance from their home slot, so a lookup is a
+ short linear probe through contiguous memory instead of a walk down a
+ bucket's linked list of heap nodes.
+
+ Robin Hood insertion:  while probing, an entry that is closer to its
+ home slot than the one being inserted gives up its slot, which keeps
+ probe lengths short and lets find() stop early.  Deletion shifts the
+ following entries of the cluster back one slot (no tombstones), so
+ tables never fill up with dead slots under insert/erase churn.
+
+ The interface is the subset of std::unordered_map that edgeContainer
+ uses.  The slot array comes from (a rebound copy of) the allocator A.
+ NOTE: insert() and erase() invalidate iterators.
+*/
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <memory>
+
+template <class T, class A = std::allocator<char> >
+class myhash {
+public:
+  typedef std::pair<int, T> value_type;
+  typedef A                 allocator_type;
+private:
+  struct slot {
+    value_type v;
+    int dist;        // distance from home slot, -1 when empty
+    slot() : v(), dist(-1) {}
+  };
+  typedef typename std::allocator_traits<A>::template
+    rebind_alloc<slot> alloc_t;
+  typedef std::vector<slot, alloc_t> slots_t;
+public:
+  // (key, value) as seen through an iterator:  the key is read only, as
+  // in std::unordered_map (changing it would break the probe order)
+  template <class V>
+  struct entryRef {
+    int const& first;
+    V&         second;
+    operator value_type() const { return value_type(first, second); }
+  };
+
+  // iterators step over the empty slots
+  template <class V, class P>
+  class iter {
+  public:
+    // operator-> must return something that itself has an operator->
+    struct arrow {
+      entryRef<V> r;
+      entryRef<V> const* operator->() const { return &r; }
+    };
+
+    iter() : m_p(0), m_end(0) {}
+    iter(P p, P e) : m_p(p), m_end(e) { skip(); }
+    template <class V2, class P2>
+    iter(iter<V2, P2> const& o) : m_p(o.m_p), m_end(o.m_end) {}
+
+    entryRef<V> operator*() const
+      { entryRef<V> r = { m_p->v.first, m_p->v.second }; return r; }
+    arrow operator->() const
+      { arrow a = { { m_p->v.first, m_p->v.second } }; return a; }
+    iter& operator++() { ++m_p; skip(); return *this; }
+    iter operator++(int) { iter t(*this); ++*this; return t; }
+    bool operator==(iter const& o) const { return m_p == o.m_p; }
+    bool operator!=(iter const& o) const { return m_p != o.m_p; }
+  private:
+    template <class V2, class P2> friend class iter;
+    friend class myhash;
+    void skip() { while (m_p != m_end && m_p->dist < 0) ++m_p; }
+    P m_p;
+    P m_end;
+  };
+  typedef iter<T, slot*>             iterator;
+  typedef iter<T const, slot const*> const_iterator;
+
+  explicit myhash(allocator_type const& a = allocator_type())
+    : m_slots(alloc_t(a)), m_size(0), m_shift(32) {}
+
+  iterator       begin()       { return iterator(first(), last()); }
+  const_iterator begin() const { return const_iterator(first(), last()); }
+  iterator       end()         { return iterator(last(), last()); }
+  const_iterator end()   const { return const_iterator(last(), last()); }
+
+  allocator_type get_allocator() const
+    { return allocator_type(m_slots.get_allocator()); }
+
+  size_t size() const { return m_size; }
+  bool   empty() const { return m_size == 0; }
+
+  iterator       find(int key);
+  const_iterator find(int key) const;
+
+  std::pair<iterator, bool> insert(value_type const& v);
+  T& operator[] (int key) { return insert(value_type(key, T())).first->second; }
+
+  void   erase(const_iterator it);
+  size_t erase(int key);
+  void   clear();
+
+  size_t bucket_count() const { return m_slots.size(); }
+  size_t bucket_size(size_t i) const { return m_slots[i].dist >= 0; }
+  float  load_factor() const
+    { return m_slots.empty() ? 0.0 : m_size / (float) m_slots.size(); }
+  void   rehash(size_t nbuckets);
+  void   reserve(size_t n) { if (!fits(n)) rehash(n + n / 4 + 1); }
+
+  size_t heapBytes() const { return m_slots.capacity() * sizeof(slot); }
+private:
+  slot*       first()       { return m_slots.empty() ? 0 : &m_slots[0]; }
+  slot const* first() const { return m_slots.empty() ? 0 : &m_slots[0]; }
+  slot*       last()        { return first() + m_slots.size(); }
+  slot const* last()  const { return first() + m_slots.size(); }
+
+  // maximum load factor of 0.8 (n entries fit without a rehash)
+  bool fits(size_t n) const { return 5 * n <= 4 * m_slots.size(); }
+  // multiplicative (Fibonacci) hashing:  top bits of key * 2^32/phi
+  size_t home(int key) const
+    { return (unsigned int) key * 2654435769u >> m_shift; }
+  size_t mask() const { return m_slots.size() - 1; }
+  size_t lookup(int key) const;   // slot index of key or bucket_count()
+
+  slots_t      m_slots;    // power of 2 number of slots (or none)
+  size_t       m_size;     // number of entries
+  unsigned int m_shift;    // 32 - log2(number of slots)
+};
+
+template <class T, class A>
+inline size_t myhash<T, A>::lookup(int key) const
+{
+  if (m_size == 0)
+    return m_slots.size();
+
+  size_t pos = home(key);
+  for (int dist = 0; ; dist++) {
+    slot const& s = m_slots[pos];
+    // an entry closer to home than we are means key can't be further on
+    if (s.dist < dist)
+      return m_slots.size();
+    if (s.v.first == key)
+      return pos;
+    pos = (pos + 1) & mask();
+  }
+}
+
+template <class T, class A>
+inline typename myhash<T, A>::iterator myhash<T, A>::find(int key)
+{
+  size_t pos = lookup(key);
+  return (pos == m_slots.size()) ? end() : iterator(first() + pos, last());
+}
+
+template <class T, class A>
+inline typename myhash<T, A>::const_iterator myhash<T, A>::find(int key) const
+{
+  size_t pos = lookup(key);
+  return (pos == m_slots.size()) ? end()
+    : const_iterator(first() + pos, last());
+}
+
+template <class T, class A>
+inline std::pair<typename myhash<T, A>::iterator, bool>
+myhash<T, A>::insert(value_type const& v)
+{
+  iterator it = find(v.first);
+  if (it != end())
+    return std::pair<iterator, bool>(it, false);   // already present
+
+  if (!fits(m_size + 1))
+    rehash(m_slots.empty() ? 4 : 2 * m_slots.size());
+
+  slot carry;
+  carry.v = v;
+  carry.dist = 0;
+  size_t pos = home(v.first);
+  size_t where = m_slots.size();   // slot v itself ends up in
+  for (;;) {
+    slot& s = m_slots[pos];
+    if (s.dist < 0) {              // empty:  done
+      s = carry;
+      if (where == m_slots.size())
+	where = pos;
+      break;
+    }
+    if (s.dist < carry.dist) {     // rob the rich:  swap and carry on
+      std::swap(s, carry);
+      if (where == m_slots.size())
+	where = pos;
+    }
+    carry.dist++;
+    pos = (pos + 1) & mask();
+  }
+  m_size++;
+  return std::pair<iterator, bool>(iterator(first() + where, last()), true);
+}
+
+// backward shift deletion
+template <class T, class A>
+inline void myhash<T, A>::erase(const_iterator it)
+{
+  size_t pos = it.m_p - first();
+  for (;;) {
+    size_t next = (pos + 1) & mask();
+    if (m_slots[next].dist <= 0) {   // empty or at home:  end of shift
+      m_slots[pos] = slot();
+      break;
+    }
+    m_slots[pos] = m_slots[next];
+    m_slots[pos].dist--;
+    pos = next;
+  }
+  m_size--;
+}
+
+template <class T, class A>
+inline size_t myhash<T, A>::erase(int key)
+{
+  size_t pos = lookup(key);
+  if (pos == m_slots.size())
+    return 0;
+  erase(const_iterator(first() + pos, last()));
+  return 1;
+}
+
+template <class T, class A>
+inline void myhash<T, A>::clear()
+{
+  for (size_t i = 0; i < m_slots.size(); i++) {
+    m_slots[i] = slot();
+  }
+  m_size = 0;
+}
+
+// resize to the smallest power of 2 >= nbuckets that still holds every
+// entry (so rehash(0) shrinks to fit) and reinsert
+template <class T, class A>
+inline void myhash<T, A>::rehash(size_t nbuckets)
+{
+  size_t n = 4;
+  unsigned int shift = 30;
+  while (n < nbuckets || 5 * m_size > 4 * n) {
+    n *= 2;
+    shift--;
+  }
+  if (m_size == 0 && nbuckets == 0) {   // nothing to hold:  free it all
+    slots_t(m_slots.get_allocator()).swap(m_slots);
+    m_shift = 32;
+    return;
+  }
+
+  slots_t old(n, slot(), m_slots.get_allocator());
+  old.swap(m_slots);
+  m_shift = shift;
+  m_size = 0;
+  for (size_t i = 0; i < old.size(); i++) {
+    if (old[i].dist >= 0)
+      insert(old[i].v);
+  }
+}
+
+#endif // myhash_hpp
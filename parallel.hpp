@@ -0,0 +1,86 @@
+#ifndef parallel_hpp
+#define parallel_hpp
+
+/*
+ Minimal fork/join helpers on top of std::thread.  parallelRun(n, fn)
+ calls fn(tid) for tid = 0 .. n-1, each on its own thread (tid 0 on the
+ calling thread), and returns once all of them have finished.  Within
+ one run, the threads can work in lock step, meeting at a spinBarrier.
+ Programs using these need -pthread.
+
+ The parallel algorithms (bfs.hpp, sssp.hpp, ...) pass their nthreads
+ through threadCount() first, so nthreads <= 0 means defaultThreads()
+ there, as it does for concurrentBuilder.
+*/
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// a sensible default thread count (hardware threads, at least 1)
+inline int defaultThreads()
+{
+  int n = std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+// a requested thread count:  nthreads <= 0 asks for the default
+inline int threadCount(int nthreads)
+{
+  return nthreads > 0 ? nthreads : defaultThreads();
+}
+
+template <class F>
+void parallelRun(int nthreads, F fn)
+{
+  std::vector<std::thread> threads;
+  threads.reserve(nthreads > 1 ? nthreads - 1 : 0);
+  for (int t = 1; t < nthreads; t++) {
+    threads.push_back(std::thread(fn, t));
+  }
+  fn(0);
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+}
+
+// split [0, n) into nparts contiguous ranges;  part p is [lo, hi)
+inline void splitRange(int n, int nparts, int p, int& lo, int& hi)
+{
+  lo = (int) (((long long) n * p + nparts - 1) / nparts);
+  hi = (int) (((long long) n * (p + 1) + nparts - 1) / nparts);
+}
+
+// the part of splitRange(n, nparts, ...) that i falls in
+inline int rangeOwner(int n, int nparts, int i)
+{
+  return (int) ((long long) i * nparts / n);
+}
+
+// a reusable barrier for a fixed number of threads (e.g. the threads
+// of one parallelRun() meeting between the steps of an algorithm).
+// waiters spin, yielding, so keep the work between barriers coarse
+class spinBarrier {
+public:
+  explicit spinBarrier(int nthreads)
+    : m_n(nthreads), m_count(nthreads), m_gen(0) {}
+
+  void wait()
+  {
+    const int gen = m_gen.load();
+    if (m_count.fetch_sub(1) == 1) {   // last one in:  release the rest
+      m_count.store(m_n);
+      m_gen.fetch_add(1);
+    }
+    else {
+      while (m_gen.load() == gen)
+	std::this_thread::yield();
+    }
+  }
+private:
+  const int m_n;
+  std::atomic<int> m_count;   // threads yet to arrive
+  std::atomic<int> m_gen;     // bumped each time everyone has arrived
+};
+
+#endif // parallel_hpp
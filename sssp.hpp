@@ -0,0 +1,245 @@
+#ifndef sssp_hpp
+#define sssp_hpp
+
+/*
+ Single source shortest paths over nonnegative integer edge weights
+ (the edge information T, e.g. iw_ungraph's depths).
+
+ dijkstra() keeps its queue in a radix heap:  Dijkstra only ever pops
+ keys >= the last key popped, so entries can be binned by the highest
+ bit in which they differ from that key, and an entry moves down at
+ most 64 bins over its life;  no comparisons between entries at all.
+
+ deltaStepping() is the parallel variant (Meyer and Sanders, with the
+ bucket handling of the GAP benchmark suite):  vertices are settled a
+ bucket of distances [i*delta, (i+1)*delta) at a time;  the threads
+ share out the current bucket's vertices, relax their edges with an
+ atomic min on the distance and file improved vertices in per thread
+ bins, from which the next (lowest) bucket is gathered.  delta = 0
+ picks the mean edge weight.  Parents are found afterwards from the
+ final distances (the smallest u with dist[u] + w(u, v) = dist[v]),
+ so they don't depend on the thread count;  that needs positive
+ weights (zero weight cycles could make parent cycles).
+
+ Both work over digraph/ungraph, cowgraph and csrgraph (read from its
+ raw arrays).  dist[v] is the length of a shortest path from src (-1
+ if unreachable), parent[v] v's predecessor on one (-1 for src and
+ unreachable vertices).
+*/
+
+#include <vector>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+
+#include "bfs.hpp"
+
+// monotone priority queue of (key, value):  every key pushed must be
+// >= the last key popped
+template <class V>
+class radixHeap {
+public:
+  typedef unsigned long long key_t;
+  typedef std::pair<key_t, V> entry;
+
+  radixHeap() : m_last(0), m_size(0) {}
+
+  bool   empty() const { return m_size == 0; }
+  size_t size()  const { return m_size; }
+
+  void  push(key_t key, V const& v)
+    { m_bins[bin(key)].push_back(entry(key, v)); m_size++; }
+  entry pop();
+private:
+  int bin(key_t key) const
+    { return key == m_last ? 0 : 64 - __builtin_clzll(key ^ m_last); }
+
+  std::vector<entry> m_bins[65];   // bin i:  highest differing bit i-1
+  key_t  m_last;                   // last key popped
+  size_t m_size;
+};
+
+template <class V>
+inline typename radixHeap<V>::entry radixHeap<V>::pop()
+{
+  if (m_bins[0].empty()) {
+    // the lowest nonempty bin holds the new minimum:  make it the last
+    // key and spread that bin over the bins below
+    int i = 1;
+    while (m_bins[i].empty())
+      i++;
+    std::vector<entry>& b = m_bins[i];
+    m_last = b[0].first;
+    for (size_t j = 1; j < b.size(); j++) {
+      m_last = std::min(m_last, b[j].first);
+    }
+    for (size_t j = 0; j < b.size(); j++) {
+      m_bins[bin(b[j].first)].push_back(b[j]);
+    }
+    b.clear();
+  }
+  entry e = m_bins[0].back();
+  m_bins[0].pop_back();
+  m_size--;
+  return e;
+}
+
+template <class G>
+void dijkstra(G const& g, int src, std::vector<long long>& dist,
+	      std::vector<int>& parent)
+{
+  const int n = g.numVerts();
+  dist.assign(n, -1);
+  parent.assign(n, -1);
+  std::vector<bool> done(n, false);
+
+  radixHeap<int> q;
+  dist[src] = 0;
+  q.push(0, src);
+  while (!q.empty()) {
+    radixHeap<int>::entry e = q.pop();
+    const int v = e.second;
+    if (done[v])
+      continue;               // a stale entry (v was reached cheaper)
+    done[v] = true;
+    const long long dv = e.first;
+    scanEdges(g, v, [&](int w, long long wt) {
+      if (dist[w] < 0 || dv + wt < dist[w]) {
+	dist[w] = dv + wt;
+	parent[w] = v;
+	q.push(dist[w], w);
+      }
+    });
+  }
+}
+
+template <class G>
+void deltaStepping(G const& g, int src, std::vector<long long>& dist,
+		   std::vector<int>& parent, long long delta = 0,
+		   int nthreads = defaultThreads())
+{
+  nthreads = threadCount(nthreads);
+  const int n = g.numVerts();
+  const long long INF = ~0ULL >> 1;
+  const size_t CHUNK = 64;
+
+  if (delta <= 0) {           // mean edge weight
+    long long sum = 0;
+    for (int v = 0; v < n; v++) {
+      scanEdges(g, v, [&](int, long long wt) { sum += wt; });
+    }
+    delta = g.numEdges() ? std::max(1LL, sum / g.numEdges()) : 1;
+  }
+
+  std::vector<std::atomic<long long> > d(n);
+  for (int v = 0; v < n; v++) {
+    d[v].store(INF, std::memory_order_relaxed);
+  }
+  d[src].store(0);
+
+  // bins[t][i]:  vertices thread t improved to a distance in bucket i
+  std::vector<std::vector<std::vector<int> > > bins(nthreads);
+  std::vector<int> front(1, src);
+  std::vector<size_t> offset(nthreads + 1);
+  std::atomic<size_t> pos(0);
+  size_t cur = 0;             // bucket being settled
+  spinBarrier barrier(nthreads);
+
+  parallelRun(nthreads, [&](int tid) {
+    std::vector<std::vector<int> >& mine = bins[tid];
+    for (;;) {
+      // relax the edges of the current bucket's vertices
+      const long long lo = (long long) cur * delta;
+      for (;;) {
+	const size_t b = pos.fetch_add(CHUNK);
+	if (b >= front.size())
+	  break;
+	const size_t e = std::min(b + CHUNK, front.size());
+	for (size_t i = b; i < e; i++) {
+	  const int v = front[i];
+	  const long long dv = d[v].load(std::memory_order_relaxed);
+	  if (dv < lo)
+	    continue;         // settled in an earlier bucket already
+	  scanEdges(g, v, [&](int w, long long wt) {
+	    const long long nd = dv + wt;
+	    long long old = d[w].load(std::memory_order_relaxed);
+	    while (nd < old) {
+	      if (d[w].compare_exchange_weak(old, nd)) {
+		const size_t bk = nd / delta;
+		if (bk >= mine.size())
+		  mine.resize(bk + 1);
+		mine[bk].push_back(w);
+		break;
+	      }
+	    }
+	  });
+	}
+      }
+      barrier.wait();
+
+      // pick the lowest nonempty bucket (from cur on:  relaxing bucket
+      // cur can refill bucket cur itself) and lay it out as the front
+      if (tid == 0) {
+	size_t next = ~(size_t) 0;
+	for (int t = 0; t < nthreads; t++) {
+	  for (size_t i = cur; i < bins[t].size() && i < next; i++) {
+	    if (!bins[t][i].empty()) {
+	      next = i;
+	      break;
+	    }
+	  }
+	}
+	cur = next;
+	offset[0] = 0;
+	for (int t = 0; t < nthreads; t++) {
+	  size_t sz = (next < bins[t].size()) ? bins[t][next].size() : 0;
+	  offset[t+1] = offset[t] + sz;
+	}
+	front.resize(offset[nthreads]);
+	pos.store(0);
+      }
+      barrier.wait();
+      if (cur == ~(size_t) 0)
+	break;
+      if (cur < mine.size()) {
+	std::copy(mine[cur].begin(), mine[cur].end(),
+		  front.begin() + offset[tid]);
+	mine[cur].clear();
+      }
+      barrier.wait();
+    }
+  });
+
+  dist.resize(n);
+  for (int v = 0; v < n; v++) {
+    const long long dv = d[v].load(std::memory_order_relaxed);
+    dist[v] = (dv == INF) ? -1 : dv;
+  }
+
+  // parents:  smallest u on a tight edge u -> v (by ranges of u)
+  std::vector<std::atomic<int> > par(n);
+  for (int v = 0; v < n; v++) {
+    par[v].store(-1, std::memory_order_relaxed);
+  }
+  parallelRun(nthreads, [&](int tid) {
+    int lo, hi;
+    splitRange(n, nthreads, tid, lo, hi);
+    for (int u = lo; u < hi; u++) {
+      if (dist[u] < 0)
+	continue;
+      scanEdges(g, u, [&](int v, long long wt) {
+	if (v == src || dist[u] + wt != dist[v])
+	  return;
+	int p = par[v].load();
+	while ((p < 0 || u < p) && !par[v].compare_exchange_weak(p, u))
+	  ;
+      });
+    }
+  });
+  parent.resize(n);
+  for (int v = 0; v < n; v++) {
+    parent[v] = par[v].load(std::memory_order_relaxed);
+  }
+}
+
+#endif // sssp_hpp
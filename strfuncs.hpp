@@ -16,6 +16,19 @@ inline std::string num2str(T num)
   return ss.str();
 }
 
+// narrow integer types are numbers here, not characters
+template <>
+inline std::string num2str<unsigned char>(unsigned char num)
+{
+  return num2str<int>(num);
+}
+
+template <>
+inline std::string num2str<signed char>(signed char num)
+{
+  return num2str<int>(num);
+}
+
 template <typename T>
 inline std::string num2str(T num, int width)
 {
@@ -2,6 +2,8 @@
 #define ungraph_hpp
 
 #include <string>
+#include <map>
+#include <limits>
 #include "digraph.hpp"
 
 /*
@@ -11,17 +13,59 @@
  method done to edge, (i, j), is also done to edge (j, i).
 */
 
+/*
+ What ungraph::delDeg12Nodes() took out, so that results on the reduced
+ graph can be mapped back.  Vertex ids don't change (removed vertices
+ are just left without edges);  an edge (a, b) of the reduced graph
+ that replaced a chain a - v1 - ... - vk - b has chain(a, b) =
+ { v1, ..., vk }, and expand() turns a path of the reduced graph into
+ the path of the original graph it stands for.
+*/
+struct deg12Map {
+  typedef std::pair<int, int> vpair;
+
+  std::map<vpair, std::vector<int> > chains;  // (a, b), a < b:  a's end first
+  std::vector<int> removed;                   // in order of removal
+
+  std::vector<int> chain(int a, int b) const;   // (listed from a to b)
+  std::vector<int> expand(std::vector<int> const& path) const;
+};
+
+// whether a + b fits in T (always, for T without numeric limits)
 template <class T>
-class ungraph : public digraph<T> {
+inline bool sumFits(T const& a, T const& b)
+{
+  if (!std::numeric_limits<T>::is_specialized
+      || !std::numeric_limits<T>::is_integer || b <= T(0))
+    return true;
+  return a <= std::numeric_limits<T>::max() - b;
+}
+
+template <class T, class S = defaultEdges, class A = std::allocator<char> >
+class ungraph : public digraph<T, S, A> {
 public:
   // initialize a graph with nverts
-  explicit ungraph(int nverts);
+  explicit ungraph(int nverts, A const& alloc = A());
 
   bool addEdge(int src, int dst, T const& e);
   bool delEdge(int src, int dst);
 
+  // bulk add undirected edges (see digraph<T, S, A>::addEdges()):
+  // returns the number of undirected edges actually added
+  template <class EdgeIter>
+  int addEdges(EdgeIter first, EdgeIter last, bool compact = false);
+
   void delAllEdges(int src);  // delete ALL edges IN/OUT to/from src
-  void delDeg12Nodes(int src, int dst);
+
+  // contract away every vertex but src and dst of degree 1 (repeatedly:
+  // whole pendant trees go) or 2 (a chain a - v - b becomes one edge
+  // (a, b) weighing the sum;  if (a, b) is there already the lighter
+  // one is kept;  a chain whose weight would overflow T stays as it
+  // is).  shortest path distances between the remaining vertices
+  // don't change.  returns the number of vertices removed
+  int delDeg12Nodes(int src, int dst, deg12Map& map);
+  int delDeg12Nodes(int src, int dst)
+    { deg12Map map; return delDeg12Nodes(src, dst, map); }
 
   T& getEdge(int src, int dst); // **** NOT IMPLEMENTED  (NEEDED?) ****
 
@@ -34,66 +78,153 @@ protected:
   // undirected graph
 
   // make inherited non-const variant protected or private
-  typename ungraph<T>::umapEdge& operator[] (int src);
+  typename ungraph<T, S, A>::umapEdge& operator[] (int src);
 
-  void delEdge(int src, typename digraph<T>::umapEdge::iterator ditr);
+  void delEdge(int src, typename digraph<T, S, A>::umapEdge::iterator ditr);
 };
 
-template <class T>
-inline ungraph<T>::ungraph(int nverts)
-  : digraph<T>(nverts)
+template <class T, class S, class A>
+inline ungraph<T, S, A>::ungraph(int nverts, A const& alloc)
+  : digraph<T, S, A>(nverts, alloc)
 {
 }
 
 // add undirected weighted edge between src <-> dst
-template <class T>
-inline bool ungraph<T>::addEdge(int src, int dst, T const& e)
+template <class T, class S, class A>
+inline bool ungraph<T, S, A>::addEdge(int src, int dst, T const& e)
 {
   // NOTE:  using "this" didn't work (segmentation fault)
   //return this->addEdge(src, dst, e) && this->addEdge(dst, src, e);
-  return digraph<T>::addEdge(src, dst, e).second
-    && digraph<T>::addEdge(dst, src, e).second;
+  return digraph<T, S, A>::addEdge(src, dst, e).second
+    && digraph<T, S, A>::addEdge(dst, src, e).second;
+}
+
+// add both directions of every edge in one bulk digraph<T, S, A>::addEdges()
+template <class T, class S, class A>
+template <class EdgeIter>
+int ungraph<T, S, A>::addEdges(EdgeIter first, EdgeIter last, bool compact)
+{
+  typedef typename digraph<T, S, A>::edge edge;
+
+  std::vector<edge> both;
+  for (EdgeIter it = first; it != last; ++it) {
+    both.push_back(edge(it->src, it->dst, it->e));
+    both.push_back(edge(it->dst, it->src, it->e));
+  }
+  return digraph<T, S, A>::addEdges(both.begin(), both.end(), compact) / 2;
 }
 
 // delete undirected weighted edge between src <-> dst
-template <class T>
-inline bool ungraph<T>::delEdge(int src, int dst)
+template <class T, class S, class A>
+inline bool ungraph<T, S, A>::delEdge(int src, int dst)
 {
-  return digraph<T>::delEdge(src, dst) && digraph<T>::delEdge(dst, src);
+  return digraph<T, S, A>::delEdge(src, dst)
+    && digraph<T, S, A>::delEdge(dst, src);
 }
 
-template <class T>
+template <class T, class S, class A>
 inline void
-ungraph<T>::delEdge(int src, typename digraph<T>::umapEdge::iterator ditr)
+ungraph<T, S, A>::delEdge(int src,
+			  typename digraph<T, S, A>::umapEdge::iterator ditr)
 {
   // must do this (dst, src) first, then (src, ditr)
-  digraph<T>::delEdge(ditr->first, src);
-  digraph<T>::delEdge(src, ditr);
+  digraph<T, S, A>::delEdge(ditr->first, src);
+  digraph<T, S, A>::delEdge(src, ditr);
 }
 
-template <class T>
-inline void ungraph<T>::delAllEdges(int src)   // delete ALL IN and OUT edges
+template <class T, class S, class A>
+inline void ungraph<T, S, A>::delAllEdges(int src) // delete ALL IN/OUT edges
 {
-  digraph<T>::delInEdges(src);
-  digraph<T>::delOutEdges(src);
+  digraph<T, S, A>::delInEdges(src);
+  digraph<T, S, A>::delOutEdges(src);
 }
 
-template <class T>
-inline typename ungraph<T>::umapEdge& ungraph<T>::operator[] (int src)
+template <class T, class S, class A>
+int ungraph<T, S, A>::delDeg12Nodes(int src, int dst, deg12Map& map)
 {
-  return digraph<T>::operator[](src);
+  typedef deg12Map::vpair vpair;
+  const int before = map.removed.size();
+
+  std::vector<int> todo;              // vertices whose degree dropped
+  for (int v = digraph<T, S, A>::numVerts() - 1; v >= 0; v--) {
+    todo.push_back(v);
+  }
+  while (!todo.empty()) {
+    const int v = todo.back();
+    todo.pop_back();
+    const int degree = digraph<T, S, A>::adj(v).size();
+    if (v == src || v == dst || degree == 0 || degree > 2
+	|| digraph<T, S, A>::findEdge(v, v) != digraph<T, S, A>::adj(v).end())
+      continue;                       // (self loops:  left alone)
+
+    typename digraph<T, S, A>::const_iterator it =
+      digraph<T, S, A>::adj(v).begin();
+    const int a = it->first;
+    const T wa = it->second;
+    int b = -1;
+    T wb = T();
+    if (degree == 2) {
+      ++it;
+      b = it->first;
+      wb = it->second;
+      if (!sumFits(wa, wb))
+	continue;                     // (the chain's weight would wrap)
+    }
+
+    std::vector<int> path = map.chain(a, v);
+    map.chains.erase(vpair(std::min(a, v), std::max(a, v)));
+    delEdge(v, a);
+    map.removed.push_back(v);
+
+    if (degree == 1) {                // pendant:  a may be one now
+      todo.push_back(a);
+      continue;
+    }
+
+    path.push_back(v);
+    std::vector<int> rest = map.chain(v, b);
+    path.insert(path.end(), rest.begin(), rest.end());
+    map.chains.erase(vpair(std::min(v, b), std::max(v, b)));
+    delEdge(v, b);
+
+    const T w = wa + wb;
+    if (a > b)
+      std::reverse(path.begin(), path.end());
+    const vpair ab(std::min(a, b), std::max(a, b));
+    typename digraph<T, S, A>::umapEdge::iterator e = (*this)[a].find(b);
+    if (e == (*this)[a].end()) {
+      addEdge(a, b, w);
+      map.chains[ab].swap(path);
+      continue;
+    }
+    if (w < e->second) {              // a lighter parallel edge
+      e->second = w;
+      (*this)[b].find(a)->second = w;
+      map.chains[ab].swap(path);
+    }
+    todo.push_back(a);                // (both lost an edge)
+    todo.push_back(b);
+  }
+  return map.removed.size() - before;
 }
 
-template <class T>
-void ungraph<T>::calc_node_degree_stats(int& min_degree, int& max_degree,
+template <class T, class S, class A>
+inline typename ungraph<T, S, A>::umapEdge&
+ungraph<T, S, A>::operator[] (int src)
+{
+  return digraph<T, S, A>::operator[](src);
+}
+
+template <class T, class S, class A>
+void ungraph<T, S, A>::calc_node_degree_stats(int& min_degree, int& max_degree,
 					double& avg_degree) const
 {
-  min_degree = digraph<T>::numVerts();
+  min_degree = digraph<T, S, A>::numVerts();
   max_degree = 0;
   int total_degrees = 0;
 
-  for (int i = 0; i < digraph<T>::numVerts(); i++) {
-    int degree = digraph<T>::adj(i).size();
+  for (int i = 0; i < digraph<T, S, A>::numVerts(); i++) {
+    int degree = digraph<T, S, A>::adj(i).size();
     total_degrees += degree;
     if (degree > max_degree)
       max_degree = degree;
@@ -101,7 +232,32 @@ void ungraph<T>::calc_node_degree_stats(int& min_degree, int& max_degree,
       min_degree = degree;
   }
 
-  avg_degree = total_degrees / (double) digraph<T>::numVerts();
+  avg_degree = total_degrees / (double) digraph<T, S, A>::numVerts();
+}
+
+inline std::vector<int> deg12Map::chain(int a, int b) const
+{
+  std::map<vpair, std::vector<int> >::const_iterator it =
+    chains.find(vpair(std::min(a, b), std::max(a, b)));
+  if (it == chains.end())
+    return std::vector<int>();
+  std::vector<int> res(it->second);
+  if (a > b)
+    std::reverse(res.begin(), res.end());
+  return res;
+}
+
+inline std::vector<int> deg12Map::expand(std::vector<int> const& path) const
+{
+  std::vector<int> res;
+  for (size_t i = 0; i < path.size(); i++) {
+    if (i > 0) {
+      std::vector<int> c = chain(path[i-1], path[i]);
+      res.insert(res.end(), c.begin(), c.end());
+    }
+    res.push_back(path[i]);
+  }
+  return res;
 }
 
 #endif // ungraph_hpp